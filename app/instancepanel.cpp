@@ -27,6 +27,8 @@
 #include "widgetmanager.h"
 #include "aboutdialog.h"
 #include "utils.h"
+#include "viewsnapshot.h"
+#include <widgetsinstrumentation.h>
 
 #include <QDebug>
 #include <QHBoxLayout>
@@ -47,14 +49,22 @@ static const char* MoveMimeDataFormat = "application/dde-widgets-instancedata";
 InstancePanelCell::InstancePanelCell(Instance *instance, QWidget *parent)
     : DragDropWidget(parent)
     , m_instance(instance)
+    , m_snapshot(new ViewSnapshot(this))
 {
     setFocusPolicy(Qt::NoFocus);
+    m_snapshot->setView(m_instance->view(), m_instance->isUserAreaInstance());
     show();
 }
 
 void InstancePanelCell::setInstance(Instance *instance)
 {
     m_instance = instance;
+    m_snapshot->setView(m_instance->view(), m_instance->isUserAreaInstance());
+}
+
+Instance *InstancePanelCell::instance() const
+{
+    return m_instance;
 }
 
 QWidget *InstancePanelCell::view() const
@@ -77,6 +87,11 @@ bool InstancePanelCell::isCustom() const
     return WidgetHandlerImpl::get(m_instance->handler())->isCustom();
 }
 
+QPixmap InstancePanelCell::snapshot() const
+{
+    return m_snapshot->pixmap();
+}
+
 QList<QWidget *> InstancePanelCell::focusWidgetList() const
 {
     return {};
@@ -101,14 +116,14 @@ void InstancePanelCell::startDrag(const QPoint &pos)
     dataStream << m_instance->handler()->id() << hotSpot;
     mimeData->setData(MoveMimeDataFormat, itemData);
 
-    QPixmap pixmap(child->grab());
-    pixmap.setMask(WidgetContainer::bitmapOfMask(pixmap.size(), m_instance->isUserAreaInstance()));
+    const QPixmap &pixmap = snapshot();
 
     QDrag *drag = new QDrag(this);
     drag->setMimeData(mimeData);
     drag->setPixmap(pixmap);
     drag->setHotSpot(hotSpot);
 
+    FrameTraceScope trace("instance-drag");
     Qt::DropAction dropAction = drag->exec(Qt::MoveAction);
 
     if (dropAction == Qt::IgnoreAction) {
@@ -229,8 +244,10 @@ void InstancePanel::addWidgetImpl(const InstanceId &key, InstancePos pos)
         });
     }
 
+    cell->installEventFilter(this);
     auto newItem = new AnimationWidgetItem(cell);
     m_layout->insertItem(pos, newItem);
+    m_cellIndex.invalidate();
 }
 
 void InstancePanel::moveWidget(const InstancePos &source, InstancePos target)
@@ -245,6 +262,7 @@ void InstancePanel::moveWidget(const InstancePos &source, InstancePos target)
 
     m_layout->removeWidget(cell);
     m_layout->insertItem(target, new AnimationWidgetItem(cell));
+    m_cellIndex.invalidate();
     tabOrderChanged();
 }
 
@@ -252,11 +270,15 @@ void InstancePanel::removeWidget(const InstanceId &id)
 {
     const InstancePos index = m_model->instancePosition(id);
 
-    auto cell = m_layout->itemAt(index)->widget();
+    auto cell = qobject_cast<InstancePanelCell *>(m_layout->itemAt(index)->widget());
     Q_ASSERT(cell);
 
     m_layout->removeWidget(cell);
+    cell->removeEventFilter(this);
+    // 实例随后才释放，不能让组件视图随单元格一起析构
+    cell->instance()->detachView();
     cell->deleteLater();
+    m_cellIndex.invalidate();
     tabOrderChanged();
 }
 
@@ -292,59 +314,86 @@ void InstancePanel::setView()
     }
 }
 
-int InstancePanel::positionCell(const QPoint &pos) const
+QHash<InstanceId, IWidget::VisibilityState> InstancePanel::visibilityStates(const IWidget::VisibilityState visibleState) const
 {
+    QHash<InstanceId, IWidget::VisibilityState> states;
+    const QWidget *viewport = m_scrollView ? m_scrollView->viewport() : nullptr;
     for (int i = 0; i < m_layout->count(); i++) {
-        auto cell = m_layout->itemAt(i)->widget();
-        if (cell->geometry().contains(pos)) {
-            return i;
+        auto cell = qobject_cast<InstancePanelCell *>(m_layout->itemAt(i)->widget());
+        if (!cell)
+            continue;
+
+        bool visible = true;
+        if (viewport) {
+            const QRect rect(cell->mapTo(viewport, QPoint(0, 0)), cell->size());
+            visible = viewport->rect().intersects(rect);
         }
+        states[cell->id()] = visible ? visibleState : IWidget::ScrolledOff;
     }
-    return -1;
+    return states;
 }
 
-static qlonglong qrectArea(const QRect &rect)
+int InstancePanel::positionCell(const QPoint &pos) const
 {
-    return rect.width() * rect.height();
+    return cellIndex().indexAt(pos);
 }
 
 // In cell > Intersected cell > Empty cell
 int InstancePanel::positionCell(const QPoint &pos, const QSize &size, const QPoint &hotSpot) const
 {
-    const auto index = positionCell(pos);
-    if (index >= 0)
-        return index;
+    const auto &index = cellIndex();
+    const auto cellPos = index.indexAt(pos);
+    if (cellPos >= 0)
+        return cellPos;
 
-    const QRect boundingRect(pos - hotSpot, size);
-    // max intersected area and it's index.
-    QPair<InstancePos, qlonglong> maxIntersected{-1, 0};
-    for (int i = 0; i < m_layout->count(); i++) {
-        auto cell = m_layout->itemAt(i)->widget();
-        if (!cell->geometry().intersects(boundingRect))
-            continue;
+    // get the largest intersected Rect as the target position.
+    const auto intersectedPos = index.maxIntersected(QRect(pos - hotSpot, size));
+    if (intersectedPos >= 0)
+        return intersectedPos;
 
-        // get the largest intersected Rect as the target position.
-        const auto intersectedArea = qrectArea(cell->geometry().intersected(boundingRect));
-        if (maxIntersected.second < intersectedArea)
-            maxIntersected = qMakePair(i, intersectedArea);
-    }
-    if (maxIntersected.first >= 0)
-        return maxIntersected.first;
+    // pos is maybe in empty area, test pre cell whether contains the pos.
+    const auto prePos = index.indexAt(QPoint(pos.x() - size.width(), pos.y()));
+    if (prePos >= 0)
+        return prePos + 1;
 
-    for (int i = 0; i < m_layout->count(); i++) {
-        auto cell = m_layout->itemAt(i)->widget();
-        // pos is maybe in empty area, test pre cell whether contains the pos.
-        if (cell->geometry().contains(pos.x() - size.width(), pos.y())) {
-            return i + 1;
-        }
+    return -1;
+}
+
+const CellSpatialIndex &InstancePanel::cellIndex() const
+{
+    if (!m_cellIndex.isValid() || m_cellIndex.count() != m_layout->count()) {
+        QVector<QRect> rects;
+        rects.reserve(m_layout->count());
+        for (int i = 0; i < m_layout->count(); i++)
+            rects << m_layout->itemAt(i)->widget()->geometry();
+
+        m_cellIndex.rebuild(rects);
     }
+    return m_cellIndex;
+}
 
-    return -1;
+bool InstancePanel::eventFilter(QObject *watched, QEvent *event)
+{
+    if (event->type() == QEvent::Move || event->type() == QEvent::Resize)
+        m_cellIndex.invalidate();
+
+    return QWidget::eventFilter(watched, event);
 }
 
 void InstancePanel::dragEnterEvent(QDragEnterEvent *event)
 {
+    m_dragPayload = DragPayload();
     if (event->mimeData()->hasFormat(MoveMimeDataFormat)) {
+        QByteArray itemData = event->mimeData()->data(MoveMimeDataFormat);
+        QDataStream dataStream(&itemData, QIODevice::ReadOnly);
+        dataStream >> m_dragPayload.id >> m_dragPayload.hotSpot;
+        if (auto instance = m_model->getInstance(m_dragPayload.id)) {
+            m_dragPayload.size = instance->handler()->size();
+            m_dragPayload.isValid = true;
+        }
+        // cell's geometry may be changed by animation before dragging.
+        m_cellIndex.invalidate();
+
         if (canDragDrop(event)) {
             event->acceptProposedAction();
         } else {
@@ -370,16 +419,12 @@ void InstancePanel::dragMoveEvent(QDragMoveEvent *event)
 void InstancePanel::dropEvent(QDropEvent *event)
 {
     if (event->mimeData()->hasFormat(MoveMimeDataFormat)) {
-        QByteArray itemData = event->mimeData()->data(MoveMimeDataFormat);
-        QDataStream dataStream(&itemData, QIODevice::ReadOnly);
-
-        QPoint hotSpot;
-        InstanceId id;
-        dataStream >> id >> hotSpot;
-        if (auto instance = m_model->getInstance(id)) {
-            auto target = positionCell(event->pos(), instance->handler()->size(), hotSpot);
+        const DragPayload payload = m_dragPayload;
+        m_dragPayload = DragPayload();
+        if (payload.isValid && m_model->getInstance(payload.id)) {
+            auto target = positionCell(event->pos(), payload.size, payload.hotSpot);
             if (canDragDrop(target)) {
-                m_model->moveInstance(id, target);
+                m_model->moveInstance(payload.id, target);
                 event->accept();
                 return;
             }
@@ -388,6 +433,12 @@ void InstancePanel::dropEvent(QDropEvent *event)
     }
 }
 
+void InstancePanel::dragLeaveEvent(QDragLeaveEvent *event)
+{
+    m_dragPayload = DragPayload();
+    QWidget::dragLeaveEvent(event);
+}
+
 bool InstancePanel::canDragDrop(const InstancePos pos) const
 {
     if (pos >= 0 && pos < m_layout->count()) {
@@ -400,13 +451,8 @@ bool InstancePanel::canDragDrop(const InstancePos pos) const
 
 bool InstancePanel::canDragDrop(QDropEvent *event) const
 {
-    QByteArray itemData = event->mimeData()->data(MoveMimeDataFormat);
-    QDataStream dataStream(&itemData, QIODevice::ReadOnly);
-    QPoint hotSpot;
-    InstanceId id;
-    dataStream >> id >> hotSpot;
-    if (auto instance = m_model->getInstance(id)) {
-        auto target = positionCell(event->pos(), instance->handler()->size(), hotSpot);
+    if (m_dragPayload.isValid) {
+        auto target = positionCell(event->pos(), m_dragPayload.size, m_dragPayload.hotSpot);
         return canDragDrop(target);
     }
     return true;
@@ -462,7 +508,7 @@ void InstancePanel::onMenuRequested(const InstanceId &id)
         menu->addSeparator();
 
         QAction *action = menu->addAction(qApp->translate("InstancePanel", "about widget"));
-        connect(action, &QAction::triggered, this, [this, instance](){
+        connect(action, &QAction::triggered, this, [this, instance, id](){
             auto plugin = m_manager->getPlugin(instance->handler()->pluginId());
             if (!plugin)
                 return;
@@ -471,9 +517,10 @@ void InstancePanel::onMenuRequested(const InstanceId &id)
 
             auto logo = plugin->logo();
             if(logo.isNull()) {
-                QPixmap pixmap(instance->view()->grab());
-                pixmap.setMask(WidgetContainer::bitmapOfMask(pixmap.size(), instance->isUserAreaInstance()));
-                logo = QIcon(pixmap);
+                if (auto item = m_layout->itemAt(m_model->instancePosition(id))) {
+                    if (auto cell = qobject_cast<InstancePanelCell *>(item->widget()))
+                        logo = QIcon(cell->snapshot());
+                }
             }
             dialog.setLogo(logo);
             dialog.setTitle(plugin->title());
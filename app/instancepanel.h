@@ -24,25 +24,31 @@
 #include "global.h"
 #include <widgetsinterface.h>
 #include <dflowlayout.h>
+#include <QHash>
 #include "utils.h"
+#include "cellspatialindex.h"
 
 DWIDGET_USE_NAMESPACE
+WIDGETS_USE_NAMESPACE
 
 class QScrollArea;
 WIDGETS_FRAME_BEGIN_NAMESPACE
 class InstanceModel;
 class WidgetManager;
+class ViewSnapshot;
 class InstancePanelCell : public DragDropWidget {
     Q_OBJECT
 public:
     explicit InstancePanelCell(Instance *instance, QWidget *parent = nullptr);
 
     void setInstance(Instance *instance);
+    Instance *instance() const;
     QWidget *view() const;
     InstanceId id() const;
     virtual void setView() = 0;
     bool isFixted() const;
     bool isCustom() const;
+    QPixmap snapshot() const;
 
     virtual QList<QWidget *> focusWidgetList() const;
 
@@ -51,6 +57,7 @@ protected:
 
 protected:
     Instance *m_instance;
+    ViewSnapshot *m_snapshot = nullptr;
 };
 
 class InstancePanel : public QWidget {
@@ -66,6 +73,9 @@ public:
 
     virtual InstancePanelCell *createWidget(Instance *instance) = 0;
 
+    // 与滚动区域可视范围相交的组件为 visibleState，其余为 ScrolledOff
+    QHash<InstanceId, IWidget::VisibilityState> visibilityStates(const IWidget::VisibilityState visibleState) const;
+
 Q_SIGNALS:
     void tabOrderChanged();
 public Q_SLOTS:
@@ -87,11 +97,22 @@ protected:
     virtual void dragEnterEvent(QDragEnterEvent *event) override;
     virtual void dragMoveEvent(QDragMoveEvent *event) override;
     virtual void dropEvent(QDropEvent *event) override;
+    virtual void dragLeaveEvent(QDragLeaveEvent *event) override;
+    virtual bool eventFilter(QObject *watched, QEvent *event) override;
 
     bool canDragDrop(const InstancePos pos) const;
 private:
     bool canDragDrop(QDropEvent *event) const;
     void addWidgetImpl(const InstanceId &key, InstancePos pos);
+    const CellSpatialIndex &cellIndex() const;
+
+    // 拖拽数据仅在dragEnterEvent中解析一次
+    struct DragPayload {
+        bool isValid = false;
+        InstanceId id;
+        QPoint hotSpot;
+        QSize size;
+    };
 
 protected:
     WidgetManager *m_manager = nullptr;
@@ -101,5 +122,7 @@ private:
     DFlowLayout *m_layout = nullptr;
     bool m_mode = false;
     QScrollArea *m_scrollView = nullptr;
+    mutable CellSpatialIndex m_cellIndex;
+    DragPayload m_dragPayload;
 };
 WIDGETS_FRAME_END_NAMESPACE
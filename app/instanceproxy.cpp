@@ -22,11 +22,16 @@
 #include "instanceproxy.h"
 
 #include "widgethandler.h"
+#include "roundedcornercache.h"
+#include "tickscheduler.h"
+#include "taskexecutor.h"
+#include "memoryaccountant.h"
+#include "pluginlibrary.h"
 #include <QBitmap>
 #include <QDebug>
 #include <QEvent>
 #include <QHBoxLayout>
-#include <QPainter>
+#include <QLabel>
 #include <QResizeEvent>
 #include <QWidget>
 
@@ -35,25 +40,57 @@ WIDGETS_FRAME_BEGIN_NAMESPACE
 InstanceProxy::InstanceProxy(IWidget *impl)
     : QObject()
     , m_impl(impl)
+    , m_extension(dynamic_cast<IWidgetExtension *>(impl))
 {
+    // 组件自身的定时器、D-Bus 回复等事件也记到插件上
+    if (auto object = dynamic_cast<QObject *>(impl))
+        MemoryAccountant::instance()->tagObject(object, handler()->pluginId());
 }
 
 InstanceProxy::~InstanceProxy()
 {
-    if (m_containerView)
-        m_containerView->deleteLater();
+    {
+        // 视图在统计区间内创建，也需要在区间内同步释放，否则释放的内存不会记回插件
+        MemoryScope scope(handler()->pluginId());
+        QPointer<QWidget> view;
+        if (m_containerView) {
+            view = m_containerView->takeView();
+            delete m_containerView.data();
+        }
+        m_extension = nullptr;
+        m_impl.reset();
+        // 组件没有自己释放视图时由框架释放
+        if (view)
+            delete view.data();
+    }
+    if (m_library)
+        m_library->deref();
 }
 
 QWidget *InstanceProxy::view() const
 {
     if (!m_containerView) {
+        MemoryScope scope(handler()->pluginId());
         m_containerView = new WidgetContainer(m_impl->view());
         m_containerView->setIsUserAreaInstance(isUserAreaInstance());
+        MemoryAccountant::instance()->tagObject(m_containerView, handler()->pluginId());
     }
 
     return m_containerView;
 }
 
+bool InstanceProxy::hasView() const
+{
+    return !m_containerView.isNull();
+}
+
+void InstanceProxy::detachView()
+{
+    // 容器作为单元格的子控件析构时不在统计区间内，视图也只会延迟释放
+    if (m_containerView && m_containerView->parentWidget())
+        m_containerView->setParent(nullptr);
+}
+
 WidgetHandler *InstanceProxy::handler() const
 {
     return m_impl->handler();
@@ -61,41 +98,114 @@ WidgetHandler *InstanceProxy::handler() const
 
 void InstanceProxy::typeChanged(const IWidget::Type &type)
 {
+    wakeup();
+    MemoryScope scope(handler()->pluginId());
     return m_impl->typeChanged(type);
 }
 
 bool InstanceProxy::initialize(const QStringList &arguments)
 {
+    MemoryScope scope(handler()->pluginId());
     return m_impl->initialize(arguments);
 }
 
 void InstanceProxy::delayInitialize()
 {
+    MemoryScope scope(handler()->pluginId());
     return m_impl->delayInitialize();
 }
 
 void InstanceProxy::showWidgets()
 {
+    MemoryScope scope(handler()->pluginId());
     return m_impl->showWidgets();
 }
 
 void InstanceProxy::hideWidgets()
 {
+    MemoryScope scope(handler()->pluginId());
     return m_impl->hideWidgets();
 }
 
+void InstanceProxy::visibilityChanged(const IWidget::VisibilityState state)
+{
+    if (m_hasVisibilityState && m_visibilityState == state)
+        return;
+
+    m_hasVisibilityState = true;
+    m_visibilityState = state;
+    const bool isPaused = state == IWidget::Hidden || state == IWidget::ScrolledOff;
+    TickScheduler::instance()->setInstancePaused(handler()->id(), isPaused);
+
+    if (!m_extension)
+        return;
+
+    MemoryScope scope(handler()->pluginId());
+    return m_extension->visibilityChanged(state, !isUserAreaInstance());
+}
+
+IWidget::VisibilityState InstanceProxy::visibilityState() const
+{
+    return m_visibilityState;
+}
+
 void InstanceProxy::aboutToShutdown()
 {
+    TaskExecutor::instance()->cancelAll(handler()->id());
+    MemoryScope scope(handler()->pluginId());
     return m_impl->aboutToShutdown();
 }
 
+bool InstanceProxy::hibernate()
+{
+    if (m_isHibernated || !m_containerView || !m_extension)
+        return false;
+
+    const QPixmap &snapshot = m_containerView->grab();
+    {
+        MemoryScope scope(handler()->pluginId());
+        if (!m_extension->hibernate())
+            return false;
+    }
+
+    qDebug(dwLog()) << "hibernate widget." << handler()->pluginId() << handler()->id();
+    m_isHibernated = true;
+    m_containerView->setSnapshot(snapshot);
+    return true;
+}
+
+void InstanceProxy::wakeup()
+{
+    if (!m_isHibernated)
+        return;
+
+    qDebug(dwLog()) << "wakeup widget." << handler()->pluginId() << handler()->id();
+    m_isHibernated = false;
+    MemoryScope scope(handler()->pluginId());
+    m_extension->wakeup();
+    if (m_containerView)
+        m_containerView->setView(m_impl->view());
+    m_impl->typeChanged(handler()->type());
+    // 新的视图需要重新同步可见状态
+    if (m_hasVisibilityState && m_extension)
+        m_extension->visibilityChanged(m_visibilityState, !isUserAreaInstance());
+}
+
+bool InstanceProxy::isHibernated() const
+{
+    return m_isHibernated;
+}
+
 void InstanceProxy::settings()
 {
+    wakeup();
+    MemoryScope scope(handler()->pluginId());
     return m_impl->settings();
 }
 
 bool InstanceProxy::enableSettings()
 {
+    MemoryScope scope(handler()->pluginId());
     return m_impl->enableSettings();
 }
 
@@ -104,6 +214,16 @@ bool InstanceProxy::isUserAreaInstance() const
     return WidgetHandlerImpl::get(m_impl->handler())->m_isUserAreaInstance;
 }
 
+void InstanceProxy::setLibrary(const QSharedPointer<PluginLibrary> &library)
+{
+    if (m_library)
+        m_library->deref();
+
+    m_library = library;
+    if (m_library)
+        m_library->ref();
+}
+
 WidgetContainer::WidgetContainer(QWidget *view, QWidget *parent)
     : QWidget(parent)
     , m_view(view)
@@ -124,29 +244,61 @@ WidgetContainer::~WidgetContainer()
     }
 }
 
+QWidget *WidgetContainer::takeView()
+{
+    QWidget *view = m_view;
+    if (view)
+        view->setParent(nullptr);
+    m_view = nullptr;
+    return view;
+}
+
 void WidgetContainer::setIsUserAreaInstance(const bool isUserAreaInstance)
 {
     m_isUserAreaInstance = isUserAreaInstance;
 }
 
-QBitmap WidgetContainer::bitmapOfMask(const QSize &size, const bool isUserAreaInstance)
+void WidgetContainer::setSnapshot(const QPixmap &snapshot)
 {
-    const qreal radius = isUserAreaInstance ? UI::RoundedRectRadius : UI::DataStoreRoundedRectRadius;
-    return bitmapOfMask(size, radius);
+    if (!m_snapshot) {
+        m_snapshot = new QLabel(this);
+        layout()->addWidget(m_snapshot);
+    }
+    m_snapshot->setPixmap(snapshot);
+    m_snapshot->show();
+    if (m_view)
+        m_view->hide();
 }
 
-QBitmap WidgetContainer::bitmapOfMask(const QSize &size, const qreal radius)
+void WidgetContainer::setView(QWidget *view)
 {
-    QBitmap bitMap(size);
-    bitMap.fill(Qt::color0);
+    if (m_snapshot) {
+        m_snapshot->hide();
+        m_snapshot->deleteLater();
+        m_snapshot = nullptr;
+    }
+    if (!view)
+        return;
+
+    if (m_view != view) {
+        if (m_view) {
+            m_view->setParent(nullptr);
+            m_view->deleteLater();
+        }
+        m_view = view;
+        layout()->addWidget(m_view);
+    }
+    m_view->show();
+}
 
-    QPainter painter(&bitMap);
-    painter.setRenderHint(QPainter::SmoothPixmapTransform);
-    painter.setPen(Qt::NoPen);
-    painter.setBrush(Qt::color1);
-    painter.drawRoundedRect(bitMap.rect(), radius, radius);
+QBitmap WidgetContainer::bitmapOfMask(const QSize &size, const bool isUserAreaInstance)
+{
+    return bitmapOfMask(size, RoundedCornerCache::radius(isUserAreaInstance));
+}
 
-    return bitMap;
+QBitmap WidgetContainer::bitmapOfMask(const QSize &size, const qreal radius)
+{
+    return RoundedCornerCache::instance()->mask(size, radius);
 }
 
 void WidgetContainer::resizeEvent(QResizeEvent *event)
@@ -154,7 +306,8 @@ void WidgetContainer::resizeEvent(QResizeEvent *event)
     if (event->oldSize() == event->size())
         return QWidget::resizeEvent(event);
 
-    setMask(bitmapOfMask(event->size(), m_isUserAreaInstance));
+    // 子控件无法通过合成裁剪，仍使用遮罩，但区域取自缓存，相同尺寸不再重复构建。
+    setMask(RoundedCornerCache::instance()->region(event->size(), RoundedCornerCache::radius(m_isUserAreaInstance)));
 
     return QWidget::resizeEvent(event);
 }
@@ -24,17 +24,26 @@
 #include "global.h"
 #include <QBitmap>
 #include <QPointer>
+#include <QSharedPointer>
 #include <QWidget>
 #include <widgetsinterface.h>
 
+class QLabel;
+
 WIDGETS_FRAME_BEGIN_NAMESPACE
 WIDGETS_USE_NAMESPACE
+class PluginLibrary;
 class WidgetContainer : public QWidget {
     Q_OBJECT
 public:
     explicit WidgetContainer(QWidget *view, QWidget *parent = nullptr);
     virtual ~WidgetContainer() override;
     void setIsUserAreaInstance(const bool isUserAreaInstance);
+    // 组件休眠期间以截图代替视图
+    void setSnapshot(const QPixmap &snapshot);
+    void setView(QWidget *view);
+    // 解除视图与容器的父子关系，由调用者负责释放
+    QWidget *takeView();
 
     static QBitmap bitmapOfMask(const QSize &size, const bool isUserAreaInstance);
     static QBitmap bitmapOfMask(const QSize &size, const qreal radius);
@@ -43,6 +52,7 @@ protected:
     virtual void resizeEvent(QResizeEvent *event) override;
     bool m_isUserAreaInstance = false;
     QPointer<QWidget> m_view = nullptr;
+    QLabel *m_snapshot = nullptr;
 };
 
 class InstanceProxy : public QObject {
@@ -51,6 +61,9 @@ public:
     ~InstanceProxy();
 
     QWidget *view() const;
+    bool hasView() const;
+    // 界面单元格释放前取出容器，使视图随实例在插件的统计区间内释放
+    void detachView();
     WidgetHandler *handler() const;
 
     bool initialize(const QStringList &arguments);
@@ -58,14 +71,29 @@ public:
     void typeChanged(const IWidget::Type &type);
     void showWidgets();
     void hideWidgets();
+    // 状态未变化时不会通知组件
+    void visibilityChanged(const IWidget::VisibilityState state);
+    IWidget::VisibilityState visibilityState() const;
     void aboutToShutdown();
+    // 截图后释放组件视图，组件不支持时返回false
+    bool hibernate();
+    void wakeup();
+    bool isHibernated() const;
     void settings();
     bool enableSettings();
 
     bool isUserAreaInstance() const;
+    // 实例存在期间插件动态库不会被卸载
+    void setLibrary(const QSharedPointer<PluginLibrary> &library);
 
 private:
+    QSharedPointer<PluginLibrary> m_library;
     QScopedPointer<IWidget> m_impl;
+    // 插件基于旧接口编译时为空
+    IWidgetExtension *m_extension = nullptr;
     mutable QPointer<WidgetContainer> m_containerView;
+    IWidget::VisibilityState m_visibilityState = IWidget::Hidden;
+    bool m_hasVisibilityState = false;
+    bool m_isHibernated = false;
 };
 WIDGETS_FRAME_END_NAMESPACE
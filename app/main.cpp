@@ -23,6 +23,7 @@
 #include "widgetmanager.h"
 #include "widgetsserver.h"
 #include "displaymodepanel.h"
+#include "widgetsapplication.h"
 #include "accessible/accessible.h"
 
 #include <DWidgetUtil>
@@ -38,7 +39,7 @@ int main(int argc, char *argv[])
 {
     // no inactive color for the application, and it need to be set before DApplication constructor.
     DGuiApplicationHelper::setAttribute(DGuiApplicationHelper::UseInactiveColorGroup, false);
-    DApplication a(argc, argv);
+    WIDGETS_FRAME_NAMESPACE::WidgetsApplication a(argc, argv);
     a.setApplicationVersion("1.0.0");
     a.setOrganizationName("deepin");
     a.setApplicationName("dde-widgets");
@@ -27,14 +27,21 @@
 #include "animationviewcontainer.h"
 #include "geometryhandler.h"
 #include "appearancehandler.h"
+#include "tickscheduler.h"
+#include "instanceproxy.h"
 
 #include <QDebug>
 #include <QHBoxLayout>
 #include <QScrollArea>
+#include <QScrollBar>
+#include <QElapsedTimer>
+#include <QTimerEvent>
 #include <DFontManager>
 #include <DPlatformWindowHandle>
 DGUI_USE_NAMESPACE
 WIDGETS_FRAME_BEGIN_NAMESPACE
+static const int InstanceVisibilityUpdateInterval = 50;
+
 MainView::MainView( WidgetManager *manager, QWidget *parent)
     : DBlurEffectWidget (parent)
     , m_manager(manager)
@@ -49,6 +56,7 @@ MainView::MainView( WidgetManager *manager, QWidget *parent)
     setBlurEnabled(false);
 
     setParent(m_animationContainer);
+    m_animationContainer->setContentView(this);
     m_appearancehandler->addTargetWidget(m_animationContainer);
 
     // don't display tray in Dock
@@ -78,7 +86,7 @@ MainView::MainView( WidgetManager *manager, QWidget *parent)
 
     connect(m_editModeView, &EditModePanel::editCompleted, this, [this] () {
         switchToDisplayMode();
-        m_animationContainer->showView();
+        m_animationContainer->reslideView();
     });
 
     m_displayModeView = new DisplayModePanel(m_manager);
@@ -87,7 +95,7 @@ MainView::MainView( WidgetManager *manager, QWidget *parent)
 
     connect(m_displayModeView, &DisplayModePanel::editClicked, this, [this] () {
         switchToEditMode();
-        m_animationContainer->showView();
+        m_animationContainer->reslideView();
     });
 
     m_layout->addStretch();
@@ -118,6 +126,20 @@ void MainView::init()
     m_displayModeView->init();
 
     connect(m_animationContainer, &AnimationViewContainer::outsideAreaReleased, this, &MainView::hideView);
+    connect(m_animationContainer, &AnimationViewContainer::visibilityStateChanged, this, &MainView::onVisibilityStateChanged);
+    // 首次展开时屏幕和任务栏信息可能尚未异步返回，返回及之后变化时重新计算位置
+    connect(m_geometryHandler, &GeometryHandler::geometryChanged, this, &MainView::requestGeometryUpdate);
+
+    // 滚动、模式切换及布局变化后重新计算组件的可见状态
+    connect(this, &MainView::displayModeChanged, this, &MainView::requestInstanceVisibilityUpdate);
+    connect(m_storeView, &WidgetStore::previewsChanged, this, &MainView::requestInstanceVisibilityUpdate);
+    connect(m_instanceModel, &InstanceModel::added, this, &MainView::requestInstanceVisibilityUpdate);
+    connect(m_instanceModel, &InstanceModel::moved, this, &MainView::requestInstanceVisibilityUpdate);
+    connect(m_instanceModel, &InstanceModel::replaced, this, &MainView::requestInstanceVisibilityUpdate);
+    connect(m_instanceModel, &InstanceModel::removed, this, &MainView::requestInstanceVisibilityUpdate);
+    for (auto scrollView : {m_storeView->scrollView(), m_editModeView->scrollView(), m_displayModeView->scrollView()}) {
+        connect(scrollView->verticalScrollBar(), &QScrollBar::valueChanged, this, &MainView::requestInstanceVisibilityUpdate);
+    }
 }
 
 MainView::Mode MainView::displayMode() const
@@ -125,18 +147,139 @@ MainView::Mode MainView::displayMode() const
     return m_mode;
 }
 
+int MainView::visibilityState() const
+{
+    return m_animationContainer->visibilityState();
+}
+
 void MainView::showView()
 {
     qDebug(dwLog()) << "showView()";
     m_animationContainer->showView();
-    m_manager->showAllWidgets();
 }
 
 void MainView::hideView()
 {
     qDebug(dwLog()) << "hideView()";
     m_animationContainer->hideView();
-    m_manager->hideAllWidgets();
+}
+
+void MainView::onVisibilityStateChanged(int state)
+{
+    // 插件的显示和隐藏回调只在真正离开或回到Hidden时调用一次
+    if (state != AnimationViewContainer::Hidden && !m_widgetsShown) {
+        m_widgetsShown = true;
+        m_manager->showAllWidgets();
+    } else if (state == AnimationViewContainer::Hidden && m_widgetsShown) {
+        m_widgetsShown = false;
+        m_manager->hideAllWidgets();
+    }
+    TickScheduler::instance()->setPaused(state == AnimationViewContainer::Hidden);
+    if (state == AnimationViewContainer::Hidden) {
+        if (m_hibernateInterval > 0)
+            m_hibernateTimer.start(m_hibernateInterval, this);
+    } else {
+        m_hibernateTimer.stop();
+        // 先显示截图，真实视图在之后的事件循环中分批重建
+        if (!m_hibernatedInstances.isEmpty() && !m_wakeupTimer.isActive())
+            m_wakeupTimer.start(0, this);
+    }
+    requestInstanceVisibilityUpdate();
+    Q_EMIT visibilityChanged(state);
+}
+
+void MainView::requestInstanceVisibilityUpdate()
+{
+    if (!m_instanceVisibilityTimer.isActive())
+        m_instanceVisibilityTimer.start(InstanceVisibilityUpdateInterval, this);
+}
+
+void MainView::requestGeometryUpdate()
+{
+    if (!m_geometryTimer.isActive())
+        m_geometryTimer.start(0, this);
+}
+
+void MainView::timerEvent(QTimerEvent *event)
+{
+    if (event->timerId() == m_instanceVisibilityTimer.timerId()) {
+        m_instanceVisibilityTimer.stop();
+        updateInstanceVisibility();
+    } else if (event->timerId() == m_geometryTimer.timerId()) {
+        m_geometryTimer.stop();
+        updateGeometry(m_geometryHandler->getGeometry(expectedWidth()));
+        m_animationContainer->applyGeometry();
+    } else if (event->timerId() == m_hibernateTimer.timerId()) {
+        m_hibernateTimer.stop();
+        hibernateInstances();
+    } else if (event->timerId() == m_wakeupTimer.timerId()) {
+        wakeupInstances();
+    }
+    return DBlurEffectWidget::timerEvent(event);
+}
+
+int MainView::hibernateInterval() const
+{
+    return m_hibernateInterval;
+}
+
+void MainView::setHibernateInterval(const int msecs)
+{
+    m_hibernateInterval = qMax(0, msecs);
+    if (m_hibernateInterval <= 0) {
+        m_hibernateTimer.stop();
+    } else if (visibilityState() == AnimationViewContainer::Hidden) {
+        m_hibernateTimer.start(m_hibernateInterval, this);
+    }
+}
+
+void MainView::hibernateInstances()
+{
+    if (visibilityState() != AnimationViewContainer::Hidden)
+        return;
+
+    for (auto instance : m_manager->instances()) {
+        if (instance->hibernate())
+            m_hibernatedInstances << instance;
+    }
+    qDebug(dwLog()) << "hibernate widgets, count:" << m_hibernatedInstances.count();
+}
+
+void MainView::wakeupInstances()
+{
+    // 每次事件循环只重建一个时间片内的组件，避免展开动画卡顿
+    static const int TimeSlice = 8;
+    QElapsedTimer elapsed;
+    elapsed.start();
+    while (!m_hibernatedInstances.isEmpty() && elapsed.elapsed() < TimeSlice) {
+        if (auto instance = m_hibernatedInstances.takeFirst())
+            instance->wakeup();
+    }
+
+    if (m_hibernatedInstances.isEmpty())
+        m_wakeupTimer.stop();
+}
+
+void MainView::updateInstanceVisibility()
+{
+    const bool isPanelVisible = visibilityState() != AnimationViewContainer::Hidden;
+    const bool isEditMode = m_mode == Edit;
+
+    QHash<InstanceId, IWidget::VisibilityState> states;
+    if (isPanelVisible) {
+        states = isEditMode ? m_editModeView->visibilityStates(IWidget::Editing)
+                            : m_displayModeView->visibilityStates(IWidget::Visible);
+    }
+    for (auto instance : m_manager->instances()) {
+        instance->visibilityChanged(states.value(instance->handler()->id(), IWidget::Hidden));
+    }
+
+    // 商店只在编辑模式下显示
+    const auto previewStates = m_storeView->previewStates();
+    for (auto iter = previewStates.constBegin(); iter != previewStates.constEnd(); ++iter) {
+        const auto state = isPanelVisible && isEditMode ? iter.value() : IWidget::Hidden;
+        iter.key()->visibilityChanged(state);
+    }
 }
 
 void MainView::updateGeometry(const QRect &rect)
@@ -153,6 +296,7 @@ void MainView::switchToEditMode()
     const auto targetRect = m_geometryHandler->getGeometry(expectedWidth());
     updateGeometry(targetRect);
 
+    m_storeView->loadPreviews();
     m_storeView->scrollView()->setVisible(true);
     m_layout->addWidget(m_storeView->scrollView());
 
@@ -173,6 +317,7 @@ void MainView::switchToDisplayMode()
     updateGeometry(targetRect);
 
     m_storeView->scrollView()->setVisible(false);
+    m_storeView->scheduleReleasePreviews();
     m_layout->removeWidget(m_storeView->scrollView());
     m_layout->removeWidget(m_editModeView->scrollView());
     m_layout->addWidget(m_displayModeView->scrollView());
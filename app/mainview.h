@@ -28,6 +28,8 @@
 #include <DBlurEffectWidget>
 #include <QPropertyAnimation>
 #include <QSequentialAnimationGroup>
+#include <QBasicTimer>
+#include <QPointer>
 #include <dflowlayout.h>
 
 WIDGETS_FRAME_BEGIN_NAMESPACE
@@ -55,6 +57,12 @@ public:
     void init();
 
     Mode displayMode() const;
+    // AnimationViewContainer::VisibilityState
+    int visibilityState() const;
+
+    // 面板收起超过该时间后组件休眠，0表示不休眠，单位毫秒
+    int hibernateInterval() const;
+    void setHibernateInterval(const int msecs);
 
 public Q_SLOTS:
     void showView();
@@ -69,9 +77,21 @@ public Q_SLOTS:
     void addPlugin(const PluginPath &pluginPath);
 Q_SIGNALS:
     void displayModeChanged();
+    void visibilityChanged(int state);
+
+private Q_SLOTS:
+    void onVisibilityStateChanged(int state);
+    void requestInstanceVisibilityUpdate();
+    void requestGeometryUpdate();
+
+protected:
+    virtual void timerEvent(QTimerEvent *event) override;
 
 private:
     int expectedWidth() const;
+    void updateInstanceVisibility();
+    void hibernateInstances();
+    void wakeupInstances();
 private:
     WidgetManager *m_manager = nullptr;
     WidgetStore *m_storeView;
@@ -79,11 +99,18 @@ private:
     DisplayModePanel *m_displayModeView;
     InstanceModel *m_instanceModel = nullptr;
     QHBoxLayout *m_layout = nullptr;
-    Mode m_mode;
+    Mode m_mode = Display;
 
     AnimationViewContainer *m_animationContainer;
     GeometryHandler *m_geometryHandler;
     Appearancehandler *m_appearancehandler = nullptr;
+    bool m_widgetsShown = false;
+    QBasicTimer m_instanceVisibilityTimer;
+    QBasicTimer m_geometryTimer;
+    int m_hibernateInterval = 0;
+    QBasicTimer m_hibernateTimer;
+    QBasicTimer m_wakeupTimer;
+    QList<QPointer<Instance>> m_hibernatedInstances;
 
 };
 WIDGETS_FRAME_END_NAMESPACE
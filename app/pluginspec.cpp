@@ -24,6 +24,8 @@
 #include "instanceproxy.h"
 #include "widgetsinterface_p.h"
 #include "utils.h"
+#include "memoryaccountant.h"
+#include "pluginlibrary.h"
 
 #include <QUuid>
 #include <QDebug>
@@ -32,22 +34,32 @@
 WIDGETS_FRAME_USE_NAMESPACE
 WIDGETS_BEGIN_NAMESPACE
 
+static QString deepCopy(const QString &text)
+{
+    return QString(text.unicode(), text.size());
+}
+
 WidgetPluginSpec::WidgetPluginSpec(const PluginInfo &info)
-    : m_plugin (info.plugin)
+    : m_library(new PluginLibrary(info.id, info.loader, info.plugin))
     , m_pluginId(info.id)
     , m_fileName(info.fileName)
     , m_version(info.version)
 {
-    Q_ASSERT(m_plugin);
-    m_supportTypes = m_plugin->supportTypes();
+    Q_ASSERT(info.plugin);
+    m_library->setUnloadable(info.unloadWhenIdle);
+
+    const auto plugin = info.plugin;
+    m_supportTypes = plugin->supportTypes();
+    m_type = plugin->type();
+    m_title = deepCopy(plugin->title());
+    m_description = deepCopy(plugin->description());
+    m_aboutDescription = deepCopy(plugin->aboutDescription());
+    for (const auto &item : plugin->contributors())
+        m_contributors << deepCopy(item);
 }
 
 WidgetPluginSpec::~WidgetPluginSpec()
 {
-    if (m_plugin) {
-        m_plugin->deleteLater();
-        m_plugin = nullptr;
-    }
     if (m_dataStore) {
         m_dataStore->deleteLater();
         m_dataStore = nullptr;
@@ -78,39 +90,52 @@ Instance *WidgetPluginSpec::createWidgetImpl(const IWidget::Type &type, const In
     if (!m_supportTypes.contains(type))
         return nullptr;
 
-    auto instance = m_plugin->createWidget();
+    auto plugin = m_library->plugin();
+    if (!plugin)
+        return nullptr;
+
+    IWidget *instance = nullptr;
+    WidgetHandlerImpl *handler = nullptr;
+    {
+        // 处理器随组件在区间内释放，创建时也记到插件上
+        MemoryScope scope(m_pluginId);
+        instance = plugin->createWidget();
+        if (instance)
+            handler = new WidgetHandlerImpl();
+    }
     if (!instance)
         return nullptr;
 
-    auto handler = new WidgetHandlerImpl();
     instance->d->handler = handler;
     handler->m_type = type;
     handler->m_id = key;
     handler->m_pluginId = m_pluginId;
-    handler->m_pluginType = m_plugin->type();
+    handler->m_pluginType = m_type;
     handler->setDataStore(m_dataStore);
     qDebug(dwLog()) << "created widget." << m_pluginId << type << key;
-    return new Instance(instance);
+    auto proxy = new Instance(instance);
+    proxy->setLibrary(m_library);
+    return proxy;
 }
 
 QString WidgetPluginSpec::title() const
 {
-    return m_plugin->title();
+    return m_title;
 }
 
 QString WidgetPluginSpec::description() const
 {
-    return m_plugin->description();
+    return m_description;
 }
 
 QString WidgetPluginSpec::aboutDescription() const
 {
-    return m_plugin->aboutDescription();
+    return m_aboutDescription;
 }
 
 IWidgetPlugin::Type WidgetPluginSpec::type() const
 {
-    return m_plugin->type();
+    return m_type;
 }
 
 QString WidgetPluginSpec::version() const
@@ -120,12 +145,18 @@ QString WidgetPluginSpec::version() const
 
 QIcon WidgetPluginSpec::logo() const
 {
-    return m_plugin->logo();
+    auto plugin = m_library->plugin();
+    return plugin ? plugin->logo() : QIcon();
 }
 
 QStringList WidgetPluginSpec::contributors() const
 {
-    return m_plugin->contributors();
+    return m_contributors;
+}
+
+QSharedPointer<PluginLibrary> WidgetPluginSpec::library() const
+{
+    return m_library;
 }
 
 QVector<IWidget::Type> WidgetPluginSpec::supportTypes() const
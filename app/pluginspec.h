@@ -23,16 +23,25 @@
 
 #include "global.h"
 #include <widgetsinterface.h>
+#include <QSharedPointer>
 
+class QPluginLoader;
 WIDGETS_FRAME_BEGIN_NAMESPACE
 class WidgetManager;
+class PluginLibrary;
 WIDGETS_FRAME_END_NAMESPACE
 
 struct PluginInfo {
     WIDGETS_NAMESPACE::IWidgetPlugin *plugin = nullptr;
+    // 加载插件的loader，由插件描述接管
+    QPluginLoader *loader = nullptr;
     WIDGETS_FRAME_NAMESPACE::PluginId id;
     QString fileName;
     QString version;
+    // 插件内存软预算，单位为字节，0表示不限制
+    qint64 memoryBudget = 0;
+    // 没有实例时是否允许卸载动态库
+    bool unloadWhenIdle = false;
 };
 WIDGETS_BEGIN_NAMESPACE
 
@@ -52,6 +61,7 @@ public:
 
     QVector<IWidget::Type> supportTypes() const;
     void removeSupportType(const IWidget::Type type);
+    QSharedPointer<WIDGETS_FRAME_NAMESPACE::PluginLibrary> library() const;
 
     WIDGETS_FRAME_NAMESPACE::Instance *createWidget(const IWidget::Type &type);
     WIDGETS_FRAME_NAMESPACE::Instance *createWidget(const IWidget::Type &type, const WIDGETS_FRAME_NAMESPACE::InstanceId &key);
@@ -62,12 +72,18 @@ private:
     WIDGETS_FRAME_NAMESPACE::Instance *createWidgetImpl(const IWidget::Type &type, const WIDGETS_FRAME_NAMESPACE::InstanceId &key);
     void setDataStore(WIDGETS_FRAME_NAMESPACE::DataStore *store);
 
-    IWidgetPlugin *m_plugin = nullptr;
+    QSharedPointer<WIDGETS_FRAME_NAMESPACE::PluginLibrary> m_library;
     WIDGETS_FRAME_NAMESPACE::PluginId m_pluginId;
     WIDGETS_FRAME_NAMESPACE::DataStore *m_dataStore = nullptr;
     QString m_fileName;
     QString m_version;
     QVector<IWidget::Type> m_supportTypes;
+    // 插件卸载后仍需要展示的信息，深拷贝以免引用插件内的静态数据
+    IWidgetPlugin::Type m_type;
+    QString m_title;
+    QString m_description;
+    QString m_aboutDescription;
+    QStringList m_contributors;
 
     friend class WIDGETS_FRAME_NAMESPACE::WidgetManager;
 };
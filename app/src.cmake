@@ -18,11 +18,21 @@ set(HEADERS
     ${CMAKE_CURRENT_LIST_DIR}/instancemodel.h
     ${CMAKE_CURRENT_LIST_DIR}/instancepanel.h
     ${CMAKE_CURRENT_LIST_DIR}/aboutdialog.h
+    ${CMAKE_CURRENT_LIST_DIR}/widgetsapplication.h
     ${CMAKE_CURRENT_LIST_DIR}/utils/utils.h
     ${CMAKE_CURRENT_LIST_DIR}/utils/geometryhandler.h
     ${CMAKE_CURRENT_LIST_DIR}/utils/animationviewcontainer.h
     ${CMAKE_CURRENT_LIST_DIR}/utils/appearancehandler.h
     ${CMAKE_CURRENT_LIST_DIR}/utils/button.h
+    ${CMAKE_CURRENT_LIST_DIR}/utils/roundedcornercache.h
+    ${CMAKE_CURRENT_LIST_DIR}/utils/framerecorder.h
+    ${CMAKE_CURRENT_LIST_DIR}/utils/cellspatialindex.h
+    ${CMAKE_CURRENT_LIST_DIR}/utils/viewsnapshot.h
+    ${CMAKE_CURRENT_LIST_DIR}/utils/tickscheduler.h
+    ${CMAKE_CURRENT_LIST_DIR}/utils/taskexecutor.h
+    ${CMAKE_CURRENT_LIST_DIR}/utils/memoryaccountant.h
+    ${CMAKE_CURRENT_LIST_DIR}/utils/allocationcounter.h
+    ${CMAKE_CURRENT_LIST_DIR}/utils/pluginlibrary.h
     ${CMAKE_CURRENT_LIST_DIR}/accessible/accessible.h
 )
 set(SOURCES
@@ -38,11 +48,21 @@ set(SOURCES
     ${CMAKE_CURRENT_LIST_DIR}/instancemodel.cpp
     ${CMAKE_CURRENT_LIST_DIR}/instancepanel.cpp
     ${CMAKE_CURRENT_LIST_DIR}/aboutdialog.cpp
+    ${CMAKE_CURRENT_LIST_DIR}/widgetsapplication.cpp
     ${CMAKE_CURRENT_LIST_DIR}/utils/utils.cpp
     ${CMAKE_CURRENT_LIST_DIR}/utils/geometryhandler.cpp
     ${CMAKE_CURRENT_LIST_DIR}/utils/animationviewcontainer.cpp
     ${CMAKE_CURRENT_LIST_DIR}/utils/appearancehandler.cpp
     ${CMAKE_CURRENT_LIST_DIR}/utils/button.cpp
+    ${CMAKE_CURRENT_LIST_DIR}/utils/roundedcornercache.cpp
+    ${CMAKE_CURRENT_LIST_DIR}/utils/framerecorder.cpp
+    ${CMAKE_CURRENT_LIST_DIR}/utils/cellspatialindex.cpp
+    ${CMAKE_CURRENT_LIST_DIR}/utils/viewsnapshot.cpp
+    ${CMAKE_CURRENT_LIST_DIR}/utils/tickscheduler.cpp
+    ${CMAKE_CURRENT_LIST_DIR}/utils/taskexecutor.cpp
+    ${CMAKE_CURRENT_LIST_DIR}/utils/memoryaccountant.cpp
+    ${CMAKE_CURRENT_LIST_DIR}/utils/allocationcounter.cpp
+    ${CMAKE_CURRENT_LIST_DIR}/utils/pluginlibrary.cpp
 )
 
 include_directories(${CMAKE_CURRENT_LIST_DIR}/utils)
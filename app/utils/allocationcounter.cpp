@@ -0,0 +1,169 @@
+/*
+ * Copyright (C) 2022 UnionTech Technology Co., Ltd.
+ *
+ * Author:     yeshanshan <yeshanshan@uniontech.com>
+ *
+ * Maintainer: yeshanshan <yeshanshan@uniontech.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "allocationcounter.h"
+
+#include <atomic>
+
+// 替换分配函数会与 AddressSanitizer 冲突
+#if defined(__SANITIZE_ADDRESS__)
+#define WIDGETS_HAS_ASAN
+#elif defined(__has_feature)
+#if __has_feature(address_sanitizer)
+#define WIDGETS_HAS_ASAN
+#endif
+#endif
+
+#if defined(__GLIBC__) && !defined(WIDGETS_HAS_ASAN)
+#define WIDGETS_ALLOCATION_COUNTER
+#endif
+
+#ifdef WIDGETS_ALLOCATION_COUNTER
+#include <cerrno>
+#include <malloc.h>
+
+extern "C" {
+void *__libc_malloc(size_t size);
+void *__libc_calloc(size_t count, size_t size);
+void *__libc_realloc(void *ptr, size_t size);
+void *__libc_memalign(size_t alignment, size_t size);
+void *__libc_valloc(size_t size);
+void *__libc_pvalloc(size_t size);
+void __libc_free(void *ptr);
+}
+#endif
+
+static std::atomic<bool> gEnabled(false);
+static std::atomic<int> gRefCount(0);
+// 在分配函数中访问，不能使用需要动态分配的TLS模型
+static __thread qint64 tThreadBytes __attribute__((tls_model("initial-exec"))) = 0;
+
+#ifdef WIDGETS_ALLOCATION_COUNTER
+static inline void *counted(void *ptr)
+{
+    if (ptr && gEnabled.load(std::memory_order_relaxed))
+        tThreadBytes += qint64(malloc_usable_size(ptr));
+    return ptr;
+}
+
+// 可执行程序中的定义会替换所有动态库使用的 malloc 系列函数
+extern "C" {
+void *malloc(size_t size)
+{
+    return counted(__libc_malloc(size));
+}
+
+void free(void *ptr)
+{
+    if (ptr && gEnabled.load(std::memory_order_relaxed))
+        tThreadBytes -= qint64(malloc_usable_size(ptr));
+    __libc_free(ptr);
+}
+
+void *calloc(size_t count, size_t size)
+{
+    return counted(__libc_calloc(count, size));
+}
+
+void *realloc(void *ptr, size_t size)
+{
+    if (!gEnabled.load(std::memory_order_relaxed))
+        return __libc_realloc(ptr, size);
+
+    const qint64 oldSize = ptr ? qint64(malloc_usable_size(ptr)) : 0;
+    void *result = __libc_realloc(ptr, size);
+    if (result) {
+        tThreadBytes += qint64(malloc_usable_size(result)) - oldSize;
+    } else if (size == 0) {
+        // 大小为0时释放原内存
+        tThreadBytes -= oldSize;
+    }
+    return result;
+}
+
+void *memalign(size_t alignment, size_t size)
+{
+    return counted(__libc_memalign(alignment, size));
+}
+
+void *aligned_alloc(size_t alignment, size_t size)
+{
+    return counted(__libc_memalign(alignment, size));
+}
+
+int posix_memalign(void **memptr, size_t alignment, size_t size)
+{
+    if (alignment % sizeof(void *) != 0 || (alignment & (alignment - 1)) != 0)
+        return EINVAL;
+
+    void *ptr = __libc_memalign(alignment, size);
+    if (!ptr)
+        return ENOMEM;
+    *memptr = counted(ptr);
+    return 0;
+}
+
+void *valloc(size_t size)
+{
+    return counted(__libc_valloc(size));
+}
+
+void *pvalloc(size_t size)
+{
+    return counted(__libc_pvalloc(size));
+}
+}
+#endif
+
+WIDGETS_FRAME_BEGIN_NAMESPACE
+
+bool AllocationCounter::isSupported()
+{
+#ifdef WIDGETS_ALLOCATION_COUNTER
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool AllocationCounter::isEnabled()
+{
+    return gEnabled.load(std::memory_order_relaxed);
+}
+
+void AllocationCounter::ref()
+{
+    if (gRefCount.fetch_add(1) == 0)
+        gEnabled.store(isSupported(), std::memory_order_relaxed);
+}
+
+void AllocationCounter::deref()
+{
+    if (gRefCount.fetch_sub(1) == 1)
+        gEnabled.store(false, std::memory_order_relaxed);
+}
+
+qint64 AllocationCounter::threadBytes()
+{
+    return tThreadBytes;
+}
+
+WIDGETS_FRAME_END_NAMESPACE
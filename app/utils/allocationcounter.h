@@ -0,0 +1,44 @@
+/*
+ * Copyright (C) 2022 UnionTech Technology Co., Ltd.
+ *
+ * Author:     yeshanshan <yeshanshan@uniontech.com>
+ *
+ * Maintainer: yeshanshan <yeshanshan@uniontech.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "global.h"
+
+WIDGETS_FRAME_BEGIN_NAMESPACE
+/**
+ * @brief 按线程统计堆分配量，替换 glibc 的 malloc 系列函数实现，
+ * 开启后每次分配和释放只额外更新一次线程局部的计数，其他线程的分配不影响当前线程。
+ * 使用 AddressSanitizer 或非 glibc 环境时不可用。
+ */
+class AllocationCounter
+{
+public:
+    static bool isSupported();
+    // 引用计数，有使用者时才计数
+    static void ref();
+    static void deref();
+    static bool isEnabled();
+
+    // 开启期间当前线程分配减去释放的字节数
+    static qint64 threadBytes();
+};
+WIDGETS_FRAME_END_NAMESPACE
@@ -22,13 +22,15 @@
 #include "animationviewcontainer.h"
 #include "utils.h"
 #include <widgetsinterface.h>
+#include <widgetsinstrumentation.h>
+#include "common/dbushelper.hpp"
 
 #include <QTimer>
 #include <QDebug>
 #include <QApplication>
 #include <QScreen>
-#include <QDBusInterface>
 #include <QPropertyAnimation>
+#include <QLabel>
 
 WIDGETS_USE_NAMESPACE
 DGUI_USE_NAMESPACE
@@ -48,26 +50,37 @@ AnimationViewContainer::~AnimationViewContainer()
 
 void AnimationViewContainer::registerRegion()
 {
-    if (!m_regionMonitor) {
-        QDBusInterface interface("org.deepin.api.XEventMonitor1", "/org/deepin/api/XEventMonitor1",
-                                 "org.deepin.api.XEventMonitor1",
-                                 QDBusConnection::sessionBus());
-        if (!interface.isValid()) {
-            qWarning(dwLog()) << "registerRegion error." << interface.lastError().message();
-            return;
+    m_regionRequested = true;
+    if (m_regionMonitor) {
+        if (!m_regionMonitor->registered()) {
+            m_regionMonitor->registerRegion();
         }
-        m_regionMonitor = new DRegionMonitor(this);
-        m_regionMonitor->setCoordinateType(DRegionMonitor::Original);
-        connect(m_regionMonitor, &DRegionMonitor::buttonRelease, this, &AnimationViewContainer::regionMonitorHide, Qt::UniqueConnection);
+        return;
     }
 
-    if (!m_regionMonitor->registered()) {
-        m_regionMonitor->registerRegion();
-    }
+    // 服务是否存在异步确认，避免展开面板时阻塞在introspect上。
+    static const DBusHelper dbus("org.freedesktop.DBus", "/org/freedesktop/DBus", "org.freedesktop.DBus");
+    dbus.asyncCall<bool>("NameHasOwner", {QString("org.deepin.api.XEventMonitor1")}, this,
+                         [this](const QDBusPendingReply<bool> &reply) {
+        if (reply.isError() || !reply.value()) {
+            qWarning(dwLog()) << "registerRegion error, XEventMonitor1 isn't available." << reply.error().message();
+            return;
+        }
+        if (!m_regionMonitor) {
+            m_regionMonitor = new DRegionMonitor(this);
+            m_regionMonitor->setCoordinateType(DRegionMonitor::Original);
+            connect(m_regionMonitor, &DRegionMonitor::buttonRelease, this, &AnimationViewContainer::regionMonitorHide, Qt::UniqueConnection);
+        }
+        // 面板可能在应答返回前已经收起
+        if (m_regionRequested && !m_regionMonitor->registered()) {
+            m_regionMonitor->registerRegion();
+        }
+    });
 }
 
 void AnimationViewContainer::unRegisterRegion()
 {
+    m_regionRequested = false;
     if (nullptr == m_regionMonitor)
         return;
     if (m_regionMonitor->registered()) {
@@ -90,45 +103,146 @@ void AnimationViewContainer::regionMonitorHide(const QPoint &p)
     }
 }
 
-void AnimationViewContainer::showView()
+void AnimationViewContainer::ensureAnimation()
 {
-    if (m_currentXAni && (m_currentXAni->state() == QAbstractAnimation::Running))
+    if (m_currentXAni)
         return;
 
-    if (!m_currentXAni) {
-        m_currentXAni = new QPropertyAnimation(this, "currentX");
-        const int AnimationTime = 300;
-        m_currentXAni->setEasingCurve(QEasingCurve::Linear);
-        m_currentXAni->setDuration(AnimationTime);
+    m_currentXAni = new QPropertyAnimation(this, "currentX");
+    const int AnimationTime = 300;
+    m_currentXAni->setEasingCurve(QEasingCurve::Linear);
+    m_currentXAni->setDuration(AnimationTime);
+    connect(m_currentXAni, &QPropertyAnimation::finished, this, &AnimationViewContainer::endSnapshot);
+    connect(m_currentXAni, &QPropertyAnimation::finished, this, &AnimationViewContainer::onSlideFinished);
+    connect(m_currentXAni, &QPropertyAnimation::finished, this, []() {
+        Instrumentation::instance()->endFrameTrace("panel-slide");
+    });
+}
+
+void AnimationViewContainer::beginSnapshot()
+{
+    if (!m_snapshotAnimationEnabled || !m_contentView)
+        return;
+
+    if (!m_snapshotView) {
+        m_snapshotView = new QLabel(this);
+        m_snapshotView->setAttribute(Qt::WA_TransparentForMouseEvents);
     }
 
-    const auto &rect = m_targetRect;
-    qDebug(dwLog()) << "show view:" << rect;
+    // 动画期间只移动一张截图，真实的控件树不再参与重绘，结束后再换回。
+    m_snapshotView->setPixmap(m_contentView->grab());
+    m_snapshotView->setGeometry(m_contentView->geometry());
+    m_snapshotView->raise();
+    m_snapshotView->show();
+    m_contentView->setUpdatesEnabled(false);
+}
+
+void AnimationViewContainer::endSnapshot()
+{
+    if (!m_snapshotView || m_snapshotView->isHidden())
+        return;
+
+    if (m_contentView)
+        m_contentView->setUpdatesEnabled(true);
+
+    m_snapshotView->hide();
+    m_snapshotView->clear();
+}
+
+AnimationViewContainer::VisibilityState AnimationViewContainer::visibilityState() const
+{
+    return m_visibilityState;
+}
+
+void AnimationViewContainer::showView()
+{
+    qDebug(dwLog()) << "show view:" << m_targetRect << m_visibilityState;
+    switch (m_visibilityState) {
+    case Showing:
+        return;
+    case Hiding:
+        // 反向播放正在进行的收起动画
+        registerRegion();
+        m_currentXAni->setDirection(QAbstractAnimation::Backward);
+        setVisibilityState(Showing);
+        return;
+    case Shown:
+        return;
+    case Hidden:
+        break;
+    }
+
+    ensureAnimation();
+    setVisibilityState(Showing);
+    beginSnapshot();
     show();
 
     registerRegion();
-    m_currentXAni->setStartValue(rect.left());
-    m_currentXAni->setEndValue(rect.right());
-    m_currentXAni->setDirection(QAbstractAnimation::Backward);
-    m_currentXAni->start();
-    disconnect(m_currentXAni, &QPropertyAnimation::finished, this, &AnimationViewContainer::hide);
+    startSlide(QAbstractAnimation::Backward);
 }
 
-void AnimationViewContainer::hideView()
+void AnimationViewContainer::reslideView()
 {
-    Q_ASSERT(m_currentXAni);
-    if (m_currentXAni->state() == QAbstractAnimation::Running)
+    // 模式切换后按新的宽度重新滑入，可见状态不变
+    if (m_visibilityState != Shown || m_currentXAni->state() == QAbstractAnimation::Running)
         return;
 
-    const auto &rect = m_targetRect;
-    qDebug(dwLog()) << "hide view" << rect;
+    startSlide(QAbstractAnimation::Backward);
+}
+
+void AnimationViewContainer::hideView()
+{
+    qDebug(dwLog()) << "hide view" << m_targetRect << m_visibilityState;
+    switch (m_visibilityState) {
+    case Hidden:
+    case Hiding:
+        return;
+    case Showing:
+        unRegisterRegion();
+        m_currentXAni->setDirection(QAbstractAnimation::Forward);
+        setVisibilityState(Hiding);
+        return;
+    case Shown:
+        break;
+    }
 
     unRegisterRegion();
+    setVisibilityState(Hiding);
+    if (m_currentXAni->state() == QAbstractAnimation::Running) {
+        m_currentXAni->setDirection(QAbstractAnimation::Forward);
+        return;
+    }
+    beginSnapshot();
+    startSlide(QAbstractAnimation::Forward);
+}
+
+void AnimationViewContainer::startSlide(const QAbstractAnimation::Direction direction)
+{
+    const auto &rect = m_targetRect;
     m_currentXAni->setStartValue(rect.left());
     m_currentXAni->setEndValue(rect.right());
-    m_currentXAni->setDirection(QAbstractAnimation::Forward);
+    m_currentXAni->setDirection(direction);
+    Instrumentation::instance()->beginFrameTrace("panel-slide");
     m_currentXAni->start();
-    connect(m_currentXAni, &QPropertyAnimation::finished, this, &AnimationViewContainer::hide, Qt::UniqueConnection);
+}
+
+void AnimationViewContainer::onSlideFinished()
+{
+    if (m_visibilityState == Showing) {
+        setVisibilityState(Shown);
+    } else if (m_visibilityState == Hiding) {
+        hide();
+        setVisibilityState(Hidden);
+    }
+}
+
+void AnimationViewContainer::setVisibilityState(const VisibilityState state)
+{
+    if (m_visibilityState == state)
+        return;
+
+    m_visibilityState = state;
+    Q_EMIT visibilityStateChanged(m_visibilityState);
 }
 
 void AnimationViewContainer::updateGeometry(const QRect &rect)
@@ -138,6 +252,40 @@ void AnimationViewContainer::updateGeometry(const QRect &rect)
     qDebug() << "updateGeometry:" << m_currRect << m_targetRect;
 }
 
+void AnimationViewContainer::applyGeometry()
+{
+    if (m_visibilityState == Hidden || !m_currentXAni)
+        return;
+
+    // 显示期间位置变化时直接应用，动画进行中则更新动画的起止位置
+    if (m_currentXAni->state() == QAbstractAnimation::Running) {
+        m_currentXAni->setStartValue(m_targetRect.left());
+        m_currentXAni->setEndValue(m_targetRect.right());
+    } else {
+        setCurrentX(m_targetRect.left());
+    }
+}
+
+void AnimationViewContainer::setContentView(QWidget *view)
+{
+    m_contentView = view;
+}
+
+bool AnimationViewContainer::snapshotAnimationEnabled() const
+{
+    return m_snapshotAnimationEnabled;
+}
+
+void AnimationViewContainer::setSnapshotAnimationEnabled(const bool enabled)
+{
+    if (m_snapshotAnimationEnabled == enabled)
+        return;
+
+    m_snapshotAnimationEnabled = enabled;
+    if (!m_snapshotAnimationEnabled)
+        endSnapshot();
+}
+
 int AnimationViewContainer::currentX() const
 {
     return QWidget::x();
@@ -150,5 +298,7 @@ void AnimationViewContainer::setCurrentX(const int x)
     rect.setWidth(m_targetRect.right() - x);
     setFixedWidth(rect.width());
     setGeometry(rect);
+    // 动画期间内容被冻结，窗口只移动不重绘，需主动标记每一帧
+    Instrumentation::instance()->markFrame("panel-slide");
 }
 WIDGETS_FRAME_END_NAMESPACE
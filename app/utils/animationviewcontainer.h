@@ -23,10 +23,13 @@
 
 #include "global.h"
 #include <QWidget>
+#include <QPointer>
+#include <QAbstractAnimation>
 #include <DRegionMonitor>
 #include <DBlurEffectWidget>
 
 class QPropertyAnimation;
+class QLabel;
 DGUI_USE_NAMESPACE
 WIDGETS_FRAME_BEGIN_NAMESPACE
 DWIDGET_USE_NAMESPACE
@@ -38,12 +41,31 @@ public:
     explicit AnimationViewContainer (QWidget *parent = nullptr);
     virtual ~AnimationViewContainer() override;
 
+    enum VisibilityState {
+        Hidden,
+        Showing,
+        Shown,
+        Hiding
+    };
+    Q_ENUM(VisibilityState)
+
+    VisibilityState visibilityState() const;
+    // 动画进行中再次请求时反转当前动画，不重新开始
     void showView();
     void hideView();
+    // 已展开时按新的位置重新滑入，用于模式切换
+    void reslideView();
     void updateGeometry(const QRect &rect);
+    // 非收起状态下立即移动到updateGeometry设置的位置
+    void applyGeometry();
+
+    void setContentView(QWidget *view);
+    bool snapshotAnimationEnabled() const;
+    void setSnapshotAnimationEnabled(const bool enabled);
 
 Q_SIGNALS:
     void outsideAreaReleased();
+    void visibilityStateChanged(VisibilityState state);
 
 private Q_SLOTS:
     void regionMonitorHide(const QPoint & p);
@@ -53,11 +75,22 @@ private:
     void setCurrentX(const int x);
     void registerRegion();
     void unRegisterRegion();
+    void ensureAnimation();
+    void beginSnapshot();
+    void endSnapshot();
+    void setVisibilityState(const VisibilityState state);
+    void startSlide(const QAbstractAnimation::Direction direction);
+    void onSlideFinished();
 
 private:
     QRect m_currRect;
     QRect m_targetRect;
     QPropertyAnimation *m_currentXAni = nullptr;
     DRegionMonitor *m_regionMonitor = nullptr;
+    bool m_regionRequested = false;
+    QPointer<QWidget> m_contentView;
+    QLabel *m_snapshotView = nullptr;
+    bool m_snapshotAnimationEnabled = true;
+    VisibilityState m_visibilityState = Hidden;
 };
 WIDGETS_FRAME_END_NAMESPACE
@@ -20,6 +20,7 @@
  */
 
 #include "appearancehandler.h"
+#include "common/dbushelper.hpp"
 #include <QDebug>
 
 #include <QApplication>
@@ -34,6 +35,12 @@ Appearancehandler::Appearancehandler(QObject *parent)
     : QObject (parent)
 {
     m_appearance = new Appearance(DBusServie, DBusPath, QDBusConnection::sessionBus(), this);
+    connect(m_appearance, &Appearance::OpacityChanged, this, &Appearancehandler::setOpacity);
+
+    DBusHelper(DBusServie, DBusPath, m_appearance->interface()).asyncProperties(this, [this](const QVariantMap &properties) {
+        if (properties.contains("Opacity"))
+            setOpacity(properties.value("Opacity").toDouble());
+    });
 }
 
 Appearancehandler::~Appearancehandler()
@@ -47,16 +54,22 @@ Appearancehandler::~Appearancehandler()
 
 void Appearancehandler::addTargetWidget(DBlurEffectWidget *target)
 {
-    target->setMaskAlpha(aplpha());
-    connect(m_appearance, &Appearance::OpacityChanged, target, [this, target](double  value) {
-        target->setMaskAlpha(static_cast<quint8>(value * 255));
-    });
+    if (m_alpha >= 0)
+        target->setMaskAlpha(static_cast<quint8>(m_alpha));
     m_targets.append(target);
 }
 
 int Appearancehandler::aplpha() const
 {
-    const double value = m_appearance->opacity();
-    return static_cast<quint8>(value * 255);
+    return m_alpha;
+}
+
+void Appearancehandler::setOpacity(double value)
+{
+    m_alpha = static_cast<quint8>(value * 255);
+    for (const auto &item : qAsConst(m_targets)) {
+        if (auto target = qobject_cast<DBlurEffectWidget *>(item.data()))
+            target->setMaskAlpha(static_cast<quint8>(m_alpha));
+    }
 }
 WIDGETS_FRAME_END_NAMESPACE
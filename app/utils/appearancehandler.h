@@ -38,10 +38,15 @@ public:
 
     void addTargetWidget(DBlurEffectWidget *target);
 
+    // 未获取到外观设置时返回-1
     int aplpha() const;
 
+private Q_SLOTS:
+    void setOpacity(double value);
+
 private:
     Appearance *m_appearance = nullptr;
+    int m_alpha = -1;
     QList<QPointer<QWidget>> m_targets;
 };
 WIDGETS_FRAME_END_NAMESPACE
@@ -0,0 +1,110 @@
+/*
+ * Copyright (C) 2022 UnionTech Technology Co., Ltd.
+ *
+ * Author:     yeshanshan <yeshanshan@uniontech.com>
+ *
+ * Maintainer: yeshanshan <yeshanshan@uniontech.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "cellspatialindex.h"
+
+#include <QtMath>
+
+WIDGETS_FRAME_BEGIN_NAMESPACE
+CellSpatialIndex::CellSpatialIndex(const int bucketHeight)
+    : m_bucketHeight(qMax(1, bucketHeight))
+{
+}
+
+void CellSpatialIndex::rebuild(const QVector<QRect> &rects)
+{
+    m_rects = rects;
+    m_buckets.clear();
+    for (int i = 0; i < m_rects.size(); i++) {
+        const auto &rect = m_rects[i];
+        if (rect.isEmpty())
+            continue;
+
+        const int last = bucketOf(rect.bottom());
+        for (int bucket = bucketOf(rect.top()); bucket <= last; bucket++)
+            m_buckets[bucket] << i;
+    }
+    m_valid = true;
+}
+
+void CellSpatialIndex::invalidate()
+{
+    m_valid = false;
+}
+
+bool CellSpatialIndex::isValid() const
+{
+    return m_valid;
+}
+
+int CellSpatialIndex::count() const
+{
+    return m_rects.size();
+}
+
+int CellSpatialIndex::indexAt(const QPoint &pos) const
+{
+    const auto iter = m_buckets.constFind(bucketOf(pos.y()));
+    if (iter == m_buckets.constEnd())
+        return -1;
+
+    // 桶内按插入顺序即布局顺序保存，与线性遍历的结果一致
+    for (auto index : iter.value()) {
+        if (m_rects[index].contains(pos))
+            return index;
+    }
+    return -1;
+}
+
+int CellSpatialIndex::maxIntersected(const QRect &rect) const
+{
+    if (rect.isEmpty())
+        return -1;
+
+    int target = -1;
+    qlonglong maxArea = 0;
+    const int last = bucketOf(rect.bottom());
+    for (int bucket = bucketOf(rect.top()); bucket <= last; bucket++) {
+        const auto iter = m_buckets.constFind(bucket);
+        if (iter == m_buckets.constEnd())
+            continue;
+
+        for (auto index : iter.value()) {
+            const auto &intersected = m_rects[index].intersected(rect);
+            if (intersected.isEmpty())
+                continue;
+
+            const qlonglong area = qlonglong(intersected.width()) * intersected.height();
+            // 面积相同时取布局中靠前的单元格
+            if (area > maxArea || (area == maxArea && index < target)) {
+                maxArea = area;
+                target = index;
+            }
+        }
+    }
+    return target;
+}
+
+int CellSpatialIndex::bucketOf(const int y) const
+{
+    return qFloor(qreal(y) / m_bucketHeight);
+}
+WIDGETS_FRAME_END_NAMESPACE
@@ -0,0 +1,57 @@
+/*
+ * Copyright (C) 2022 UnionTech Technology Co., Ltd.
+ *
+ * Author:     yeshanshan <yeshanshan@uniontech.com>
+ *
+ * Maintainer: yeshanshan <yeshanshan@uniontech.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "global.h"
+#include <QHash>
+#include <QRect>
+#include <QVector>
+
+WIDGETS_FRAME_BEGIN_NAMESPACE
+/**
+ * @brief 按行分桶的单元格空间索引，用于拖拽时的命中测试。
+ * 单元格位置变化时失效，查询前按需重建。
+ */
+class CellSpatialIndex
+{
+public:
+    explicit CellSpatialIndex(const int bucketHeight = 64);
+
+    void rebuild(const QVector<QRect> &rects);
+    void invalidate();
+    bool isValid() const;
+    int count() const;
+
+    // 包含该点的单元格，不存在时返回-1
+    int indexAt(const QPoint &pos) const;
+    // 与该矩形相交面积最大的单元格，不存在时返回-1
+    int maxIntersected(const QRect &rect) const;
+
+private:
+    int bucketOf(const int y) const;
+
+    int m_bucketHeight;
+    bool m_valid = false;
+    QVector<QRect> m_rects;
+    QHash<int, QVector<int>> m_buckets;
+};
+WIDGETS_FRAME_END_NAMESPACE
@@ -0,0 +1,253 @@
+/*
+ * Copyright (C) 2022 UnionTech Technology Co., Ltd.
+ *
+ * Author:     yeshanshan <yeshanshan@uniontech.com>
+ *
+ * Maintainer: yeshanshan <yeshanshan@uniontech.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "framerecorder.h"
+#include <widgetsinstrumentation.h>
+
+#include <QApplication>
+#include <QDebug>
+#include <QEvent>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QScreen>
+#include <QWidget>
+#include <QtMath>
+
+#include <algorithm>
+
+WIDGETS_USE_NAMESPACE
+WIDGETS_FRAME_BEGIN_NAMESPACE
+static const int MaxReportCount = 32;
+static const int MaxLongFrameCount = 64;
+static const int MaxPainterCount = 8;
+// 帧间隔超过刷新周期的该倍数时视为长帧
+static const qreal LongFrameFactor = 1.5;
+
+FrameRecorder::FrameRecorder(QObject *parent)
+    : QObject(parent)
+{
+    m_clock.start();
+}
+
+FrameRecorder::~FrameRecorder()
+{
+    setEnabled(false);
+}
+
+bool FrameRecorder::isEnabled() const
+{
+    return m_enabled;
+}
+
+void FrameRecorder::setEnabled(const bool enabled)
+{
+    if (m_enabled == enabled)
+        return;
+
+    m_enabled = enabled;
+    qInfo(dwLog()) << "frame recorder enabled:" << m_enabled;
+
+    auto instrumentation = Instrumentation::instance();
+    if (m_enabled) {
+        connect(instrumentation, &Instrumentation::frameTraceBegan, this, &FrameRecorder::onFrameTraceBegan);
+        connect(instrumentation, &Instrumentation::frameTraceEnded, this, &FrameRecorder::onFrameTraceEnded);
+        connect(instrumentation, &Instrumentation::frameMarked, this, &FrameRecorder::onFrameMarked);
+        qApp->installEventFilter(this);
+    } else {
+        qApp->removeEventFilter(this);
+        disconnect(instrumentation, nullptr, this, nullptr);
+        m_sessions.clear();
+        m_painters.clear();
+    }
+    instrumentation->setEnabled(m_enabled);
+}
+
+QString FrameRecorder::report() const
+{
+    QJsonArray sessions;
+    for (const auto &item : m_reports)
+        sessions.append(item);
+
+    QJsonObject root;
+    root["enabled"] = m_enabled;
+    root["refreshRate"] = 1000.0 / frameInterval();
+    root["sessions"] = sessions;
+    root["metrics"] = QJsonObject::fromVariantMap(Instrumentation::instance()->metrics());
+    return QString::fromUtf8(QJsonDocument(root).toJson(QJsonDocument::Compact));
+}
+
+void FrameRecorder::clear()
+{
+    m_reports.clear();
+}
+
+qreal FrameRecorder::percentile(QVector<qreal> values, const qreal percent)
+{
+    if (values.isEmpty())
+        return 0;
+
+    std::sort(values.begin(), values.end());
+    // nearest-rank
+    const int rank = qBound(1, qCeil(percent / 100.0 * values.size()), values.size());
+    return values.at(rank - 1);
+}
+
+int FrameRecorder::droppedFrames(const QVector<qreal> &intervals, const qreal frameInterval)
+{
+    if (frameInterval <= 0)
+        return 0;
+
+    int dropped = 0;
+    for (auto interval : intervals) {
+        // 允许半个周期的抖动，超出的部分按整周期计为掉帧
+        const int missed = qRound(interval / frameInterval) - 1;
+        if (missed > 0)
+            dropped += missed;
+    }
+    return dropped;
+}
+
+bool FrameRecorder::eventFilter(QObject *watched, QEvent *event)
+{
+    if (m_sessions.isEmpty())
+        return QObject::eventFilter(watched, event);
+
+    switch (event->type()) {
+    case QEvent::UpdateRequest:
+        if (auto widget = qobject_cast<QWidget *>(watched)) {
+            if (widget->isWindow()) {
+                const qint64 now = m_clock.nsecsElapsed();
+                for (auto &session : m_sessions) {
+                    if (!session.marked)
+                        recordFrame(session, now);
+                }
+                m_painters.clear();
+            }
+        }
+        break;
+    case QEvent::Paint:
+        if (m_painters.size() < MaxPainterCount * 4) {
+            QString name(watched->metaObject()->className());
+            if (!watched->objectName().isEmpty())
+                name += "#" + watched->objectName();
+            m_painters.insert(name);
+        }
+        break;
+    default:
+        break;
+    }
+    return QObject::eventFilter(watched, event);
+}
+
+void FrameRecorder::onFrameTraceBegan(const QString &name)
+{
+    Session session;
+    session.name = name;
+    session.startTime = m_clock.nsecsElapsed();
+    m_sessions.insert(name, session);
+}
+
+void FrameRecorder::onFrameTraceEnded(const QString &name)
+{
+    auto iter = m_sessions.find(name);
+    if (iter == m_sessions.end())
+        return;
+
+    const auto &result = summary(iter.value());
+    qDebug(dwLog()) << "frame trace finished:" << QJsonDocument(result).toJson(QJsonDocument::Compact);
+    m_reports << result;
+    while (m_reports.size() > MaxReportCount)
+        m_reports.removeFirst();
+
+    m_sessions.erase(iter);
+    if (m_sessions.isEmpty())
+        m_painters.clear();
+}
+
+void FrameRecorder::onFrameMarked(const QString &name)
+{
+    auto iter = m_sessions.find(name);
+    if (iter == m_sessions.end())
+        return;
+
+    auto &session = iter.value();
+    if (!session.marked) {
+        // 之前按窗口重绘记录的帧与标记的帧混在一起没有意义，从第一次标记开始重新计
+        session.marked = true;
+        session.lastFrameTime = -1;
+        session.intervals.clear();
+        session.longFrames.clear();
+    }
+    recordFrame(session, m_clock.nsecsElapsed());
+}
+
+void FrameRecorder::recordFrame(Session &session, const qint64 now)
+{
+    if (session.lastFrameTime >= 0) {
+        const qreal interval = (now - session.lastFrameTime) / 1000000.0;
+        session.intervals << interval;
+        if (interval > frameInterval() * LongFrameFactor && session.longFrames.size() < MaxLongFrameCount) {
+            LongFrame frame;
+            frame.offset = (session.lastFrameTime - session.startTime) / 1000000.0;
+            frame.interval = interval;
+            frame.painters = m_painters.values().mid(0, MaxPainterCount);
+            session.longFrames << frame;
+        }
+    }
+    session.lastFrameTime = now;
+}
+
+QJsonObject FrameRecorder::summary(const Session &session) const
+{
+    const auto &intervals = session.intervals;
+
+    QJsonArray longFrames;
+    for (const auto &frame : session.longFrames) {
+        QJsonObject item;
+        item["offset"] = frame.offset;
+        item["interval"] = frame.interval;
+        item["painters"] = QJsonArray::fromStringList(frame.painters);
+        longFrames.append(item);
+    }
+
+    QJsonObject result;
+    result["name"] = session.name;
+    result["duration"] = (m_clock.nsecsElapsed() - session.startTime) / 1000000.0;
+    result["frames"] = intervals.size();
+    result["p50"] = percentile(intervals, 50);
+    result["p90"] = percentile(intervals, 90);
+    result["p99"] = percentile(intervals, 99);
+    result["max"] = percentile(intervals, 100);
+    result["dropped"] = droppedFrames(intervals, frameInterval());
+    result["longFrames"] = longFrames;
+    return result;
+}
+
+qreal FrameRecorder::frameInterval() const
+{
+    qreal refreshRate = 60;
+    if (auto screen = qApp->primaryScreen()) {
+        if (screen->refreshRate() > 1)
+            refreshRate = screen->refreshRate();
+    }
+    return 1000.0 / refreshRate;
+}
+WIDGETS_FRAME_END_NAMESPACE
@@ -0,0 +1,88 @@
+/*
+ * Copyright (C) 2022 UnionTech Technology Co., Ltd.
+ *
+ * Author:     yeshanshan <yeshanshan@uniontech.com>
+ *
+ * Maintainer: yeshanshan <yeshanshan@uniontech.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "global.h"
+#include <QObject>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QJsonObject>
+#include <QSet>
+#include <QVector>
+
+WIDGETS_FRAME_BEGIN_NAMESPACE
+/**
+ * @brief 帧时间记录器，在埋点区间内记录顶层窗口每一帧的间隔，
+ * 统计分位数及掉帧数，并将耗时过长的帧归因到该帧内绘制过的控件。
+ */
+class FrameRecorder : public QObject
+{
+    Q_OBJECT
+public:
+    explicit FrameRecorder(QObject *parent = nullptr);
+    virtual ~FrameRecorder() override;
+
+    bool isEnabled() const;
+    void setEnabled(const bool enabled);
+
+    // 以JSON格式导出最近的记录结果
+    QString report() const;
+    void clear();
+
+    static qreal percentile(QVector<qreal> values, const qreal percent);
+    static int droppedFrames(const QVector<qreal> &intervals, const qreal frameInterval);
+
+protected:
+    virtual bool eventFilter(QObject *watched, QEvent *event) override;
+
+private Q_SLOTS:
+    void onFrameTraceBegan(const QString &name);
+    void onFrameTraceEnded(const QString &name);
+    void onFrameMarked(const QString &name);
+
+private:
+    struct LongFrame {
+        qreal offset = 0;
+        qreal interval = 0;
+        QStringList painters;
+    };
+    struct Session {
+        QString name;
+        qint64 startTime = 0;
+        qint64 lastFrameTime = -1;
+        // 由埋点主动标记帧的区间，不再按窗口重绘计帧
+        bool marked = false;
+        QVector<qreal> intervals;
+        QVector<LongFrame> longFrames;
+    };
+
+    void recordFrame(Session &session, const qint64 now);
+    QJsonObject summary(const Session &session) const;
+    qreal frameInterval() const;
+
+    bool m_enabled = false;
+    QElapsedTimer m_clock;
+    QHash<QString, Session> m_sessions;
+    QSet<QString> m_painters;
+    QList<QJsonObject> m_reports;
+};
+WIDGETS_FRAME_END_NAMESPACE
@@ -20,6 +20,7 @@
  */
 
 #include "geometryhandler.h"
+#include "common/dbushelper.hpp"
 #include <QDebug>
 
 #include <QApplication>
@@ -27,7 +28,6 @@
 #include <QScreen>
 
 WIDGETS_FRAME_BEGIN_NAMESPACE
-using MonitorInter = org::deepin::dde::display1::Monitor;
 static const QString DisplayDaemonDBusServie = "org.deepin.dde.Display1";
 static const QString DisplayDaemonDBusPath = "/org/deepin/dde/Display1";
 static const QString DockDaemonDBusServie = "org.deepin.dde.daemon.Dock1";
@@ -57,6 +57,34 @@ GeometryHandler::GeometryHandler(QObject *parent)
                                           QDBusConnection::sessionBus(), this);
     m_dockDeamonInter = new DockInter(DockDaemonDBusServie, DockDaemonDBusPath,
                                       QDBusConnection::sessionBus(), this);
+
+    connect(m_dockDeamonInter, &DockInter::FrontendWindowRectChanged, this, [this](const QRect &rect) {
+        m_dockRect = rect;
+        Q_EMIT geometryChanged();
+    });
+    connect(m_dockDeamonInter, &DockInter::PositionChanged, this, [this](int position) {
+        m_dockPosition = position;
+        Q_EMIT geometryChanged();
+    });
+    connect(m_dockDeamonInter, &DockInter::DisplayModeChanged, this, [this](int mode) {
+        m_dockMode = mode;
+        Q_EMIT geometryChanged();
+    });
+    connect(m_dockDeamonInter, &DockInter::ServiceRestarted, this, &GeometryHandler::refreshDock);
+
+    connect(m_displayInter, &DisplayInter::PrimaryRectChanged, this, [this](const QRect &rect) {
+        m_primaryRect = rect;
+        Q_EMIT geometryChanged();
+    });
+    connect(m_displayInter, &DisplayInter::MonitorsChanged, this, &GeometryHandler::refreshMonitors);
+
+    refreshDock();
+    DBusHelper(DisplayDaemonDBusServie, DisplayDaemonDBusPath, m_displayInter->interface())
+            .asyncProperties(this, [this](const QVariantMap &properties) {
+        m_primaryRect = qdbus_cast<ScreenRect>(properties.value("PrimaryRect"));
+        refreshMonitors(qdbus_cast<QList<QDBusObjectPath>>(properties.value("Monitors")));
+        Q_EMIT geometryChanged();
+    });
 }
 
 GeometryHandler::~GeometryHandler()
@@ -73,12 +101,12 @@ GeometryHandler::~GeometryHandler()
 
 QRect GeometryHandler::getGeometry(const int expectedWidth)
 {
-    QRect dockRect = m_dockDeamonInter->frontendWindowRect();
+    const QRect dockRect = m_dockRect;
 
     auto displayRect = calcDisplayRect(dockRect);
 
-    auto dockPos = static_cast<Geo::DockPosition>(m_dockDeamonInter->position());
-    auto dockMode = m_dockDeamonInter->displayMode();
+    auto dockPos = static_cast<Geo::DockPosition>(m_dockPosition);
+    auto dockMode = m_dockMode;
 
     int height = displayRect.height() - Geo::CenterMargin * 2;
     if (dockPos == Geo::DockPosition::Top || dockPos == Geo::DockPosition::Bottom) {
@@ -119,13 +147,12 @@ QRect GeometryHandler::getGeometry(const int expectedWidth)
 QRect GeometryHandler::calcDisplayRect(const QRect &dockRect)
 {
     qreal ratio = qApp->primaryScreen()->devicePixelRatio();
-    QRect displayRect = m_displayInter->primaryRect();
-    QList<QDBusObjectPath> screenList = m_displayInter->monitors();
+    // 属性尚未异步返回时，先使用Qt的屏幕信息
+    QRect displayRect = m_primaryRect.isEmpty() ? qApp->primaryScreen()->geometry() : m_primaryRect;
 
-    for (const auto &screen : screenList) {
-        MonitorInter monitor("org.deepin.dde.Display1", screen.path(), QDBusConnection::sessionBus());
-        QRect monitorRect(monitor.x(), monitor.y(), monitor.width(), monitor.height());
-        if (monitor.enabled() && monitorRect.contains(dockRect.center())) {
+    for (const auto &monitor : qAsConst(m_monitors)) {
+        const QRect &monitorRect = monitor.rect;
+        if (monitor.enabled && monitorRect.contains(dockRect.center())) {
             displayRect = QRect(monitorRect.x(), monitorRect.y(),
                                 monitorRect.width() / ratio, monitorRect.height() / ratio);
             break;
@@ -133,4 +160,78 @@ QRect GeometryHandler::calcDisplayRect(const QRect &dockRect)
     }
     return displayRect;
 }
+
+void GeometryHandler::refreshDock()
+{
+    DBusHelper(DockDaemonDBusServie, DockDaemonDBusPath, m_dockDeamonInter->interface())
+            .asyncProperties(this, [this](const QVariantMap &properties) {
+        m_dockRect = qdbus_cast<DockRect>(properties.value("FrontendWindowRect"));
+        m_dockPosition = properties.value("Position").toInt();
+        m_dockMode = properties.value("DisplayMode").toInt();
+        Q_EMIT geometryChanged();
+    });
+}
+
+void GeometryHandler::refreshMonitors(const QList<QDBusObjectPath> &paths)
+{
+    QStringList targets;
+    for (const auto &item : paths)
+        targets << item.path();
+
+    for (auto iter = m_monitors.begin(); iter != m_monitors.end();) {
+        if (targets.contains(iter.key())) {
+            ++iter;
+            continue;
+        }
+        disconnect(iter.value().inter, nullptr, this, nullptr);
+        iter.value().inter->deleteLater();
+        iter = m_monitors.erase(iter);
+        Q_EMIT geometryChanged();
+    }
+
+    for (const auto &path : qAsConst(targets)) {
+        if (!m_monitors.contains(path))
+            addMonitor(path);
+    }
+}
+
+void GeometryHandler::addMonitor(const QString &path)
+{
+    Monitor monitor;
+    monitor.inter = new MonitorInter(DisplayDaemonDBusServie, path, QDBusConnection::sessionBus(), this);
+    m_monitors.insert(path, monitor);
+
+    DBusHelper(DisplayDaemonDBusServie, path, monitor.inter->interface())
+            .asyncProperties(this, [this, path](const QVariantMap &properties) {
+        auto iter = m_monitors.find(path);
+        if (iter == m_monitors.end())
+            return;
+        iter->rect = QRect(properties.value("X").toInt(), properties.value("Y").toInt(),
+                           properties.value("Width").toInt(), properties.value("Height").toInt());
+        iter->enabled = properties.value("Enabled").toBool();
+        Q_EMIT geometryChanged();
+    });
+
+    auto inter = monitor.inter;
+    connect(inter, &MonitorInter::XChanged, this, [this, path](int value) {
+        m_monitors[path].rect.moveLeft(value);
+        Q_EMIT geometryChanged();
+    });
+    connect(inter, &MonitorInter::YChanged, this, [this, path](int value) {
+        m_monitors[path].rect.moveTop(value);
+        Q_EMIT geometryChanged();
+    });
+    connect(inter, &MonitorInter::WidthChanged, this, [this, path](int value) {
+        m_monitors[path].rect.setWidth(value);
+        Q_EMIT geometryChanged();
+    });
+    connect(inter, &MonitorInter::HeightChanged, this, [this, path](int value) {
+        m_monitors[path].rect.setHeight(value);
+        Q_EMIT geometryChanged();
+    });
+    connect(inter, &MonitorInter::EnabledChanged, this, [this, path](bool value) {
+        m_monitors[path].enabled = value;
+        Q_EMIT geometryChanged();
+    });
+}
 WIDGETS_FRAME_END_NAMESPACE
@@ -23,6 +23,8 @@
 
 #include "global.h"
 #include <QObject>
+#include <QMap>
+#include <QRect>
 
 #include "display_interface.h"
 #include "monitor_interface.h"
@@ -30,7 +32,12 @@
 WIDGETS_FRAME_BEGIN_NAMESPACE
 using DisplayInter = org::deepin::dde::Display1;
 using DockInter = org::deepin::dde::daemon::Dock1;
+using MonitorInter = org::deepin::dde::display1::Monitor;
 
+/**
+ * @brief 计算面板位置，屏幕和任务栏的几何信息在启动时异步获取，之后跟随属性变化信号更新，
+ * 计算位置不再产生DBus调用。缓存变化时发出geometryChanged，使用者需重新计算位置。
+ */
 class GeometryHandler : public QObject {
     Q_OBJECT
 public:
@@ -40,8 +47,29 @@ public:
     QRect getGeometry(const int expectedWidth);
 
     QRect calcDisplayRect(const QRect &dockRect);
+
+Q_SIGNALS:
+    void geometryChanged();
+
+private Q_SLOTS:
+    void refreshDock();
+    void refreshMonitors(const QList<QDBusObjectPath> &paths);
+
 private:
+    struct Monitor {
+        MonitorInter *inter = nullptr;
+        QRect rect;
+        bool enabled = false;
+    };
+    void addMonitor(const QString &path);
+
     DisplayInter *m_displayInter = nullptr;
     DockInter *m_dockDeamonInter = nullptr;
+
+    QRect m_dockRect;
+    int m_dockPosition = 0;
+    int m_dockMode = 0;
+    QRect m_primaryRect;
+    QMap<QString, Monitor> m_monitors;
 };
 WIDGETS_FRAME_END_NAMESPACE
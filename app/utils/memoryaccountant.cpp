@@ -0,0 +1,267 @@
+/*
+ * Copyright (C) 2022 UnionTech Technology Co., Ltd.
+ *
+ * Author:     yeshanshan <yeshanshan@uniontech.com>
+ *
+ * Maintainer: yeshanshan <yeshanshan@uniontech.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "memoryaccountant.h"
+#include "allocationcounter.h"
+#include "instanceproxy.h"
+
+#include <widgetsinstrumentation.h>
+#include <QDebug>
+#include <QJsonArray>
+#include <QThread>
+#include <QCoreApplication>
+
+#include <algorithm>
+
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+
+WIDGETS_FRAME_BEGIN_NAMESPACE
+
+MemoryAccountant *MemoryAccountant::instance()
+{
+    static MemoryAccountant *gInstance = nullptr;
+    if (!gInstance)
+        gInstance = new MemoryAccountant();
+    return gInstance;
+}
+
+MemoryAccountant::MemoryAccountant(QObject *parent)
+    : QObject(parent)
+{
+    // 区间栈自身的扩容不应计入插件
+    m_scopes.reserve(16);
+}
+
+MemoryAccountant::~MemoryAccountant()
+{
+    if (m_enabled)
+        AllocationCounter::deref();
+}
+
+bool MemoryAccountant::isEnabled() const
+{
+    return m_enabled;
+}
+
+void MemoryAccountant::setEnabled(const bool enabled)
+{
+    if (m_enabled == enabled)
+        return;
+
+    if (enabled && !AllocationCounter::isSupported()) {
+        qWarning(dwLog()) << "memory accounting is not supported in this build.";
+        return;
+    }
+
+    m_enabled = enabled;
+    if (m_enabled) {
+        AllocationCounter::ref();
+    } else {
+        AllocationCounter::deref();
+        m_scopes.clear();
+    }
+}
+
+void MemoryAccountant::begin(const PluginId &pluginId)
+{
+    Scope scope;
+    scope.pluginId = pluginId;
+    scope.startBytes = AllocationCounter::threadBytes();
+    m_scopes.append(scope);
+}
+
+void MemoryAccountant::end()
+{
+    if (m_scopes.isEmpty())
+        return;
+
+    const auto scope = m_scopes.takeLast();
+    const qint64 totalBytes = AllocationCounter::threadBytes() - scope.startBytes;
+    if (!m_scopes.isEmpty())
+        m_scopes.last().childBytes += totalBytes;
+
+    account(scope.pluginId, totalBytes - scope.childBytes);
+}
+
+void MemoryAccountant::tagObject(QObject *object, const PluginId &pluginId)
+{
+    if (!object || m_owners.contains(object))
+        return;
+
+    m_owners.insert(object, pluginId);
+    connect(object, &QObject::destroyed, this, [this, object]() {
+        m_owners.remove(object);
+    });
+}
+
+PluginId MemoryAccountant::ownerOf(const QObject *object) const
+{
+    for (; object; object = object->parent()) {
+        auto iter = m_owners.constFind(object);
+        if (iter != m_owners.constEnd())
+            return iter.value();
+    }
+    return PluginId();
+}
+
+qint64 MemoryAccountant::liveBytes(const PluginId &pluginId) const
+{
+    return m_usages.value(pluginId).liveBytes;
+}
+
+qint64 MemoryAccountant::peakBytes(const PluginId &pluginId) const
+{
+    return m_usages.value(pluginId).peakBytes;
+}
+
+qint64 MemoryAccountant::budget(const PluginId &pluginId) const
+{
+    return m_usages.value(pluginId).budget;
+}
+
+void MemoryAccountant::setBudget(const PluginId &pluginId, const qint64 bytes)
+{
+    auto &usage = m_usages[pluginId];
+    usage.budget = qMax<qint64>(0, bytes);
+    usage.isOverBudget = false;
+    checkBudget(pluginId, usage);
+}
+
+void MemoryAccountant::clear()
+{
+    for (auto iter = m_usages.begin(); iter != m_usages.end(); ++iter) {
+        iter->liveBytes = 0;
+        iter->peakBytes = 0;
+        iter->isOverBudget = false;
+    }
+}
+
+void MemoryAccountant::account(const PluginId &pluginId, const qint64 bytes)
+{
+    if (bytes == 0)
+        return;
+
+    auto &usage = m_usages[pluginId];
+    usage.liveBytes += bytes;
+    usage.peakBytes = qMax(usage.peakBytes, usage.liveBytes);
+    Instrumentation::instance()->setMetric(QString("memory.%1.liveBytes").arg(pluginId), usage.liveBytes);
+
+    checkBudget(pluginId, usage);
+}
+
+void MemoryAccountant::checkBudget(const PluginId &pluginId, Usage &usage)
+{
+    const bool isOverBudget = usage.budget > 0 && usage.liveBytes > usage.budget;
+    if (usage.isOverBudget == isOverBudget)
+        return;
+
+    // 只在越过预算时告警一次，回落后重新计算
+    usage.isOverBudget = isOverBudget;
+    if (isOverBudget) {
+        qWarning(dwLog()) << "plugin exceeds the memory budget." << pluginId
+                          << "live bytes:" << usage.liveBytes << "budget:" << usage.budget;
+        Q_EMIT budgetExceeded(pluginId, usage.liveBytes, usage.budget);
+    }
+}
+
+QJsonObject MemoryAccountant::report(const QList<Instance *> &instances) const
+{
+    struct Counts {
+        int instances = 0;
+        int objects = 0;
+        int widgets = 0;
+    };
+    QHash<PluginId, Counts> counts;
+    for (auto instance : instances) {
+        auto &item = counts[instance->handler()->pluginId()];
+        ++item.instances;
+        // 只统计已创建的控件树，避免为统计而创建视图
+        if (!instance->hasView())
+            continue;
+
+        QWidget *view = instance->view();
+        item.objects += view->findChildren<QObject *>().count() + 1;
+        item.widgets += view->findChildren<QWidget *>().count() + 1;
+    }
+
+    auto pluginIds = counts.keys();
+    for (auto iter = m_usages.cbegin(); iter != m_usages.cend(); ++iter) {
+        if (!counts.contains(iter.key()))
+            pluginIds.append(iter.key());
+    }
+    std::sort(pluginIds.begin(), pluginIds.end());
+
+    QJsonArray plugins;
+    for (const auto &pluginId : qAsConst(pluginIds)) {
+        const auto &usage = m_usages.value(pluginId);
+        const auto &item = counts.value(pluginId);
+        QJsonObject plugin;
+        plugin["pluginId"] = pluginId;
+        plugin["liveBytes"] = usage.liveBytes;
+        plugin["peakBytes"] = usage.peakBytes;
+        plugin["budget"] = usage.budget;
+        plugin["overBudget"] = usage.isOverBudget;
+        plugin["instances"] = item.instances;
+        plugin["objects"] = item.objects;
+        plugin["widgets"] = item.widgets;
+        plugins.append(plugin);
+    }
+
+    QJsonObject root;
+    root["enabled"] = m_enabled;
+    root["allocatedBytes"] = allocatedBytes();
+    root["plugins"] = plugins;
+    return root;
+}
+
+qint64 MemoryAccountant::allocatedBytes()
+{
+#if defined(__GLIBC__) && __GLIBC_PREREQ(2, 33)
+    const auto info = mallinfo2();
+    return qint64(info.uordblks) + qint64(info.hblkhd);
+#elif defined(__GLIBC__)
+    const auto info = mallinfo();
+    return qint64(static_cast<unsigned int>(info.uordblks)) + qint64(static_cast<unsigned int>(info.hblkhd));
+#else
+    return 0;
+#endif
+}
+
+MemoryScope::MemoryScope(const PluginId &pluginId)
+{
+    auto accountant = MemoryAccountant::instance();
+    // 分配按线程计数，区间栈只在主线程维护
+    if (!accountant->isEnabled() || !qApp || QThread::currentThread() != qApp->thread())
+        return;
+
+    m_active = true;
+    accountant->begin(pluginId);
+}
+
+MemoryScope::~MemoryScope()
+{
+    if (m_active)
+        MemoryAccountant::instance()->end();
+}
+
+WIDGETS_FRAME_END_NAMESPACE
@@ -0,0 +1,106 @@
+/*
+ * Copyright (C) 2022 UnionTech Technology Co., Ltd.
+ *
+ * Author:     yeshanshan <yeshanshan@uniontech.com>
+ *
+ * Maintainer: yeshanshan <yeshanshan@uniontech.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "global.h"
+#include <QObject>
+#include <QHash>
+#include <QJsonObject>
+#include <QVector>
+
+WIDGETS_FRAME_BEGIN_NAMESPACE
+/**
+ * @brief 插件内存统计，在调用插件代码的区间前后采样当前线程的堆分配量，将差值记到该插件上，
+ * 并统计插件控件树中的QObject/QWidget数量；超出软预算时告警，默认关闭。
+ * 投递给插件对象树的事件（绘制、输入、定时器、D-Bus 回复等）也在区间内处理。
+ */
+class MemoryAccountant : public QObject
+{
+    Q_OBJECT
+public:
+    static MemoryAccountant *instance();
+
+    explicit MemoryAccountant(QObject *parent = nullptr);
+    virtual ~MemoryAccountant() override;
+
+    bool isEnabled() const;
+    void setEnabled(const bool enabled);
+
+    // 区间可嵌套，内层区间的分配只记到内层插件上
+    void begin(const PluginId &pluginId);
+    void end();
+
+    // 标记插件的对象树根节点，对象销毁后自动取消
+    void tagObject(QObject *object, const PluginId &pluginId);
+    // 沿父对象查找所属的插件，不属于插件时返回空
+    PluginId ownerOf(const QObject *object) const;
+
+    qint64 liveBytes(const PluginId &pluginId) const;
+    qint64 peakBytes(const PluginId &pluginId) const;
+    // 单位为字节，0表示不限制
+    qint64 budget(const PluginId &pluginId) const;
+    void setBudget(const PluginId &pluginId, const qint64 bytes);
+    void clear();
+
+    QJsonObject report(const QList<Instance *> &instances) const;
+
+    // 当前进程堆上已分配的字节数，只用于报告
+    static qint64 allocatedBytes();
+
+Q_SIGNALS:
+    void budgetExceeded(const PluginId &pluginId, const qint64 liveBytes, const qint64 budget);
+
+private:
+    struct Scope {
+        PluginId pluginId;
+        qint64 startBytes = 0;
+        qint64 childBytes = 0;
+    };
+    struct Usage {
+        qint64 liveBytes = 0;
+        qint64 peakBytes = 0;
+        qint64 budget = 0;
+        bool isOverBudget = false;
+    };
+
+    void account(const PluginId &pluginId, const qint64 bytes);
+    void checkBudget(const PluginId &pluginId, Usage &usage);
+
+    bool m_enabled = false;
+    QVector<Scope> m_scopes;
+    QHash<PluginId, Usage> m_usages;
+    QHash<const QObject *, PluginId> m_owners;
+};
+
+/**
+ * @brief 以作用域为界的插件内存统计区间
+ */
+class MemoryScope
+{
+public:
+    explicit MemoryScope(const PluginId &pluginId);
+    ~MemoryScope();
+
+private:
+    bool m_active = false;
+};
+WIDGETS_FRAME_END_NAMESPACE
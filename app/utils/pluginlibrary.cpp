@@ -0,0 +1,173 @@
+/*
+ * Copyright (C) 2022 UnionTech Technology Co., Ltd.
+ *
+ * Author:     yeshanshan <yeshanshan@uniontech.com>
+ *
+ * Maintainer: yeshanshan <yeshanshan@uniontech.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "pluginlibrary.h"
+#include "taskexecutor.h"
+
+#include <QDebug>
+#include <QPluginLoader>
+#include <QTimerEvent>
+
+WIDGETS_FRAME_BEGIN_NAMESPACE
+WIDGETS_USE_NAMESPACE
+
+// 组件视图可能延迟释放，宽限期需要远大于一次事件循环
+static const int DefaultGracePeriod = 5 * 60 * 1000;
+
+PluginLibrary::PluginLibrary(const PluginId &pluginId, QPluginLoader *loader, IWidgetPlugin *plugin, QObject *parent)
+    : QObject(parent)
+    , m_pluginId(pluginId)
+    , m_loader(loader)
+    , m_plugin(plugin)
+    , m_gracePeriod(DefaultGracePeriod)
+{
+    Q_ASSERT(m_loader);
+}
+
+PluginLibrary::~PluginLibrary()
+{
+    // 和之前一样，描述被移除时只释放插件对象，不卸载动态库
+    if (m_plugin) {
+        m_plugin->deleteLater();
+        m_plugin = nullptr;
+    }
+}
+
+IWidgetPlugin *PluginLibrary::plugin()
+{
+    if (!m_plugin) {
+        m_plugin = qobject_cast<IWidgetPlugin *>(m_loader->instance());
+        if (!m_plugin) {
+            qWarning(dwLog()) << "reload the plugin error." << m_loader->fileName() << m_loader->errorString();
+            return nullptr;
+        }
+        qDebug(dwLog()) << "reload the plugin." << m_loader->fileName();
+        Q_EMIT loaded();
+    }
+
+    // 临时使用插件后重新计算空闲时间
+    if (m_refCount <= 0)
+        scheduleUnload();
+
+    return m_plugin;
+}
+
+bool PluginLibrary::isLoaded() const
+{
+    return m_plugin != nullptr;
+}
+
+QString PluginLibrary::fileName() const
+{
+    return m_loader->fileName();
+}
+
+bool PluginLibrary::isUnloadable() const
+{
+    return m_unloadable;
+}
+
+void PluginLibrary::setUnloadable(const bool unloadable)
+{
+    if (m_unloadable == unloadable)
+        return;
+
+    m_unloadable = unloadable;
+    if (m_unloadable && m_refCount <= 0) {
+        scheduleUnload();
+    } else if (!m_unloadable) {
+        m_unloadTimer.stop();
+    }
+}
+
+int PluginLibrary::gracePeriod() const
+{
+    return m_gracePeriod;
+}
+
+void PluginLibrary::setGracePeriod(const int msecs)
+{
+    m_gracePeriod = qMax(0, msecs);
+    if (m_unloadTimer.isActive())
+        scheduleUnload();
+}
+
+int PluginLibrary::refCount() const
+{
+    return m_refCount;
+}
+
+void PluginLibrary::ref()
+{
+    ++m_refCount;
+    m_unloadTimer.stop();
+}
+
+void PluginLibrary::deref()
+{
+    Q_ASSERT(m_refCount > 0);
+    if (--m_refCount <= 0)
+        scheduleUnload();
+}
+
+bool PluginLibrary::unload()
+{
+    m_unloadTimer.stop();
+    if (!m_plugin)
+        return true;
+
+    if (m_refCount > 0)
+        return false;
+
+    // 执行中的任务仍持有插件代码，结束后再尝试
+    if (TaskExecutor::instance()->pendingCount(m_pluginId) > 0) {
+        qDebug(dwLog()) << "the plugin still has running tasks." << m_loader->fileName();
+        scheduleUnload();
+        return false;
+    }
+
+    // 卸载时由QPluginLoader释放插件对象
+    m_plugin = nullptr;
+    if (!m_loader->unload())
+        qDebug(dwLog()) << "the plugin is still used by other loaders." << m_loader->fileName();
+
+    qDebug(dwLog()) << "unload the idle plugin." << m_loader->fileName();
+    Q_EMIT unloaded();
+    return true;
+}
+
+void PluginLibrary::timerEvent(QTimerEvent *event)
+{
+    if (event->timerId() == m_unloadTimer.timerId()) {
+        unload();
+        return;
+    }
+    return QObject::timerEvent(event);
+}
+
+void PluginLibrary::scheduleUnload()
+{
+    if (!m_unloadable || !m_plugin)
+        return;
+
+    m_unloadTimer.start(m_gracePeriod, this);
+}
+WIDGETS_FRAME_END_NAMESPACE
@@ -0,0 +1,80 @@
+/*
+ * Copyright (C) 2022 UnionTech Technology Co., Ltd.
+ *
+ * Author:     yeshanshan <yeshanshan@uniontech.com>
+ *
+ * Maintainer: yeshanshan <yeshanshan@uniontech.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "global.h"
+#include <widgetsinterface.h>
+#include <QObject>
+#include <QBasicTimer>
+#include <QScopedPointer>
+
+class QPluginLoader;
+WIDGETS_FRAME_BEGIN_NAMESPACE
+/**
+ * @brief 插件动态库，由插件描述和它创建的组件实例共同持有，
+ * 没有实例引用且空闲超过宽限期后卸载，再次使用时重新加载。
+ */
+class PluginLibrary : public QObject
+{
+    Q_OBJECT
+public:
+    explicit PluginLibrary(const PluginId &pluginId, QPluginLoader *loader, WIDGETS_NAMESPACE::IWidgetPlugin *plugin,
+                           QObject *parent = nullptr);
+    virtual ~PluginLibrary() override;
+
+    // 已卸载时重新加载，失败时返回nullptr
+    WIDGETS_NAMESPACE::IWidgetPlugin *plugin();
+    bool isLoaded() const;
+    QString fileName() const;
+
+    // 插件可能注册了全局的回调或类型，只有声明了可卸载的插件才会被卸载
+    bool isUnloadable() const;
+    void setUnloadable(const bool unloadable);
+    int gracePeriod() const;
+    void setGracePeriod(const int msecs);
+
+    int refCount() const;
+    void ref();
+    void deref();
+
+    // 有实例引用或者还有后台任务未结束时不卸载
+    bool unload();
+
+Q_SIGNALS:
+    void loaded();
+    void unloaded();
+
+protected:
+    virtual void timerEvent(QTimerEvent *event) override;
+
+private:
+    void scheduleUnload();
+
+    PluginId m_pluginId;
+    QScopedPointer<QPluginLoader> m_loader;
+    WIDGETS_NAMESPACE::IWidgetPlugin *m_plugin = nullptr;
+    int m_refCount = 0;
+    bool m_unloadable = false;
+    int m_gracePeriod;
+    QBasicTimer m_unloadTimer;
+};
+WIDGETS_FRAME_END_NAMESPACE
@@ -0,0 +1,137 @@
+/*
+ * Copyright (C) 2022 UnionTech Technology Co., Ltd.
+ *
+ * Author:     yeshanshan <yeshanshan@uniontech.com>
+ *
+ * Maintainer: yeshanshan <yeshanshan@uniontech.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "roundedcornercache.h"
+
+#include <QPainter>
+
+WIDGETS_FRAME_BEGIN_NAMESPACE
+// 缓存容量以字节计，足够容纳常见的几种挂件尺寸及其在不同缩放下的资源。
+static const int MaskCacheCost = 512 * 1024;
+static const int AlphaCacheCost = 8 * 1024 * 1024;
+
+RoundedCornerCache *RoundedCornerCache::instance()
+{
+    static RoundedCornerCache *gInstance = nullptr;
+    if (!gInstance)
+        gInstance = new RoundedCornerCache();
+    return gInstance;
+}
+
+RoundedCornerCache::RoundedCornerCache()
+{
+    m_masks.setMaxCost(MaskCacheCost);
+    m_regions.setMaxCost(MaskCacheCost);
+    m_alphas.setMaxCost(AlphaCacheCost);
+}
+
+QString RoundedCornerCache::cacheKey(const QSize &size, const qreal radius, const qreal dpr) const
+{
+    return QString("%1x%2@%3r%4").arg(size.width()).arg(size.height()).arg(dpr).arg(radius);
+}
+
+QBitmap RoundedCornerCache::mask(const QSize &size, const qreal radius)
+{
+    const QString &key = cacheKey(size, radius, 1);
+    if (auto bitMap = m_masks.object(key))
+        return *bitMap;
+
+    QBitmap bitMap(size);
+    bitMap.fill(Qt::color0);
+    {
+        QPainter painter(&bitMap);
+        painter.setPen(Qt::NoPen);
+        painter.setBrush(Qt::color1);
+        painter.drawRoundedRect(bitMap.rect(), radius, radius);
+    }
+
+    const int cost = qMax(1, size.width() * size.height() / 8);
+    m_masks.insert(key, new QBitmap(bitMap), cost);
+    return bitMap;
+}
+
+QRegion RoundedCornerCache::region(const QSize &size, const qreal radius)
+{
+    const QString &key = cacheKey(size, radius, 1);
+    if (auto region = m_regions.object(key))
+        return *region;
+
+    const QRegion region(mask(size, radius));
+    m_regions.insert(key, new QRegion(region), qMax(1, region.rectCount() * int(sizeof(QRect))));
+    return region;
+}
+
+QImage RoundedCornerCache::alpha(const QSize &size, const qreal radius, const qreal dpr)
+{
+    const QString &key = cacheKey(size, radius, dpr);
+    if (auto image = m_alphas.object(key))
+        return *image;
+
+    QImage image(size * dpr, QImage::Format_ARGB32_Premultiplied);
+    image.setDevicePixelRatio(dpr);
+    image.fill(Qt::transparent);
+    {
+        QPainter painter(&image);
+        painter.setRenderHint(QPainter::Antialiasing);
+        painter.setPen(Qt::NoPen);
+        painter.setBrush(Qt::black);
+        painter.drawRoundedRect(QRectF(QPointF(0, 0), QSizeF(size)), radius, radius);
+    }
+
+    m_alphas.insert(key, new QImage(image), qMax(1, image.sizeInBytes()));
+    return image;
+}
+
+QPixmap RoundedCornerCache::rounded(const QPixmap &source, const qreal radius)
+{
+    if (source.isNull())
+        return source;
+
+    const qreal dpr = source.devicePixelRatio();
+    const QSize logicalSize = (QSizeF(source.size()) / dpr).toSize();
+
+    QImage image = source.toImage().convertToFormat(QImage::Format_ARGB32_Premultiplied);
+    image.setDevicePixelRatio(dpr);
+    {
+        QPainter painter(&image);
+        painter.setCompositionMode(QPainter::CompositionMode_DestinationIn);
+        painter.drawImage(QPointF(0, 0), alpha(logicalSize, radius, dpr));
+    }
+    return QPixmap::fromImage(image);
+}
+
+QPixmap RoundedCornerCache::rounded(const QPixmap &source, const bool isUserAreaInstance)
+{
+    return instance()->rounded(source, radius(isUserAreaInstance));
+}
+
+qreal RoundedCornerCache::radius(const bool isUserAreaInstance)
+{
+    return isUserAreaInstance ? UI::RoundedRectRadius : UI::DataStoreRoundedRectRadius;
+}
+
+void RoundedCornerCache::clear()
+{
+    m_masks.clear();
+    m_regions.clear();
+    m_alphas.clear();
+}
+WIDGETS_FRAME_END_NAMESPACE
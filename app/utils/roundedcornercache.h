@@ -0,0 +1,61 @@
+/*
+ * Copyright (C) 2022 UnionTech Technology Co., Ltd.
+ *
+ * Author:     yeshanshan <yeshanshan@uniontech.com>
+ *
+ * Maintainer: yeshanshan <yeshanshan@uniontech.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "global.h"
+#include <QBitmap>
+#include <QCache>
+#include <QImage>
+#include <QPixmap>
+#include <QRegion>
+
+WIDGETS_FRAME_BEGIN_NAMESPACE
+/**
+ * @brief 圆角资源缓存，按 (逻辑尺寸, 半径, dpr) 缓存遮罩位图及抗锯齿的透明度图，
+ * 避免每次 resize 或拖拽时重新绘制遮罩。
+ */
+class RoundedCornerCache {
+public:
+    static RoundedCornerCache *instance();
+
+    // 一位遮罩，仅用于仍需 setMask 的控件，尺寸为设备像素。
+    QBitmap mask(const QSize &size, const qreal radius);
+    QRegion region(const QSize &size, const qreal radius);
+    // 抗锯齿圆角透明度图，用于 DestinationIn 合成。
+    QImage alpha(const QSize &size, const qreal radius, const qreal dpr);
+
+    // 通过合成的方式对 pixmap 进行圆角裁剪，保留 pixmap 的 devicePixelRatio。
+    QPixmap rounded(const QPixmap &source, const qreal radius);
+    static QPixmap rounded(const QPixmap &source, const bool isUserAreaInstance);
+    static qreal radius(const bool isUserAreaInstance);
+
+    void clear();
+
+private:
+    RoundedCornerCache();
+    QString cacheKey(const QSize &size, const qreal radius, const qreal dpr) const;
+
+    QCache<QString, QBitmap> m_masks;
+    QCache<QString, QRegion> m_regions;
+    QCache<QString, QImage> m_alphas;
+};
+WIDGETS_FRAME_END_NAMESPACE
@@ -0,0 +1,223 @@
+/*
+ * Copyright (C) 2022 UnionTech Technology Co., Ltd.
+ *
+ * Author:     yeshanshan <yeshanshan@uniontech.com>
+ *
+ * Maintainer: yeshanshan <yeshanshan@uniontech.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "taskexecutor.h"
+#include <widgetsinterface.h>
+#include <widgetsinstrumentation.h>
+
+#include <QCoreApplication>
+#include <QDebug>
+#include <QRunnable>
+#include <QThread>
+
+WIDGETS_USE_NAMESPACE
+WIDGETS_FRAME_BEGIN_NAMESPACE
+static const int MaxThreadCount = 4;
+
+class TaskRunnable : public QRunnable
+{
+public:
+    TaskRunnable(TaskExecutor *executor, const int taskId, const TaskExecutor::Task &task)
+        : m_executor(executor)
+        , m_taskId(taskId)
+        , m_task(task)
+    {
+    }
+
+    virtual void run() override
+    {
+        const QVariant result = m_task();
+        // 任务由插件代码创建，在通知完成之前释放，之后插件可以安全卸载
+        m_task = TaskExecutor::Task();
+        // 执行器析构时会等待线程池结束，这里不会悬空
+        auto executor = m_executor;
+        const int taskId = m_taskId;
+        QMetaObject::invokeMethod(executor, [executor, taskId, result]() {
+            executor->finish(taskId, result);
+        }, Qt::QueuedConnection);
+    }
+
+private:
+    TaskExecutor *m_executor = nullptr;
+    int m_taskId;
+    TaskExecutor::Task m_task;
+};
+
+TaskExecutor *TaskExecutor::instance()
+{
+    static TaskExecutor *g_executor = nullptr;
+    if (!g_executor) {
+        g_executor = new TaskExecutor();
+        // 退出前等待执行中的任务结束，避免线程在插件卸载后仍在执行插件代码
+        if (qApp) {
+            QObject::connect(qApp, &QCoreApplication::aboutToQuit, qApp, []() {
+                delete g_executor;
+                g_executor = nullptr;
+            });
+        }
+    }
+    return g_executor;
+}
+
+TaskExecutor::TaskExecutor(QObject *parent)
+    : QObject(parent)
+{
+    m_pool.setMaxThreadCount(qBound(1, QThread::idealThreadCount() / 2, MaxThreadCount));
+}
+
+TaskExecutor::~TaskExecutor()
+{
+    m_pool.clear();
+    m_pool.waitForDone();
+}
+
+int TaskExecutor::submit(const PluginId &pluginId, const InstanceId &instanceId, QObject *context,
+                         const Task &task, const Finished &finished)
+{
+    if (!context || !task)
+        return -1;
+
+    TaskInfo info;
+    info.pluginId = pluginId;
+    info.instanceId = instanceId;
+    info.context = context;
+    info.task = task;
+    info.finished = finished;
+
+    const int taskId = m_nextId++;
+    m_tasks.insert(taskId, info);
+    m_stats[pluginId].queued.enqueue(taskId);
+
+    startNext(pluginId);
+    return taskId;
+}
+
+bool TaskExecutor::cancel(const int taskId)
+{
+    auto iter = m_tasks.find(taskId);
+    if (iter == m_tasks.end() || iter->isCanceled)
+        return false;
+
+    auto &stats = m_stats[iter->pluginId];
+    stats.canceled++;
+    if (iter->isRunning) {
+        // 线程无法中断，结束后丢弃结果
+        iter->isCanceled = true;
+    } else {
+        stats.queued.removeOne(taskId);
+        const PluginId pluginId = iter->pluginId;
+        m_tasks.erase(iter);
+        reportStats(pluginId);
+    }
+    return true;
+}
+
+void TaskExecutor::cancelAll(const InstanceId &instanceId)
+{
+    QList<int> taskIds;
+    for (auto iter = m_tasks.constBegin(); iter != m_tasks.constEnd(); ++iter) {
+        if (iter->instanceId == instanceId)
+            taskIds << iter.key();
+    }
+    if (!taskIds.isEmpty())
+        qDebug(dwLog()) << "cancel tasks" << instanceId << taskIds.count();
+
+    for (auto taskId : qAsConst(taskIds))
+        cancel(taskId);
+}
+
+int TaskExecutor::pluginConcurrency() const
+{
+    return m_pluginConcurrency;
+}
+
+void TaskExecutor::setPluginConcurrency(const int count)
+{
+    m_pluginConcurrency = qMax(1, count);
+    for (auto iter = m_stats.constBegin(); iter != m_stats.constEnd(); ++iter)
+        startNext(iter.key());
+}
+
+int TaskExecutor::maxThreadCount() const
+{
+    return m_pool.maxThreadCount();
+}
+
+int TaskExecutor::pendingCount(const PluginId &pluginId) const
+{
+    const auto &stats = m_stats.value(pluginId);
+    return stats.queued.count() + stats.running;
+}
+
+bool TaskExecutor::waitForDone(const int msecs)
+{
+    return m_pool.waitForDone(msecs);
+}
+
+void TaskExecutor::startNext(const PluginId &pluginId)
+{
+    auto &stats = m_stats[pluginId];
+    while (stats.running < m_pluginConcurrency && !stats.queued.isEmpty()) {
+        const int taskId = stats.queued.dequeue();
+        auto iter = m_tasks.find(taskId);
+        if (iter == m_tasks.end())
+            continue;
+
+        iter->isRunning = true;
+        stats.running++;
+        m_pool.start(new TaskRunnable(this, taskId, iter->task));
+    }
+    reportStats(pluginId);
+}
+
+void TaskExecutor::finish(const int taskId, const QVariant &result)
+{
+    auto iter = m_tasks.find(taskId);
+    if (iter == m_tasks.end())
+        return;
+
+    const TaskInfo info = iter.value();
+    m_tasks.erase(iter);
+
+    auto &stats = m_stats[info.pluginId];
+    stats.running--;
+    if (!info.isCanceled)
+        stats.finished++;
+
+    // 组件已经移除或者任务已取消，不再回调
+    if (!info.isCanceled && info.context && info.finished)
+        info.finished(result);
+
+    startNext(info.pluginId);
+}
+
+void TaskExecutor::reportStats(const PluginId &pluginId) const
+{
+    auto instrumentation = Instrumentation::instance();
+    const auto &stats = m_stats.value(pluginId);
+    const QString prefix = QString("task.%1.").arg(pluginId);
+    instrumentation->setMetric(prefix + "queued", stats.queued.count());
+    instrumentation->setMetric(prefix + "running", stats.running);
+    instrumentation->setMetric(prefix + "finished", stats.finished);
+    instrumentation->setMetric(prefix + "canceled", stats.canceled);
+    instrumentation->setMetric("task.activeThreads", m_pool.activeThreadCount());
+}
+WIDGETS_FRAME_END_NAMESPACE
@@ -0,0 +1,92 @@
+/*
+ * Copyright (C) 2022 UnionTech Technology Co., Ltd.
+ *
+ * Author:     yeshanshan <yeshanshan@uniontech.com>
+ *
+ * Maintainer: yeshanshan <yeshanshan@uniontech.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "global.h"
+#include <QObject>
+#include <QHash>
+#include <QPointer>
+#include <QQueue>
+#include <QThreadPool>
+#include <QVariant>
+
+#include <functional>
+
+WIDGETS_FRAME_BEGIN_NAMESPACE
+class TaskRunnable;
+/**
+ * @brief 组件共享的后台任务执行器，线程数有上限，每个插件同时执行的任务数也有上限，
+ * 结果在主线程中返回，任务队列的统计信息通过 Instrumentation 上报。
+ */
+class TaskExecutor : public QObject
+{
+    Q_OBJECT
+public:
+    using Task = std::function<QVariant()>;
+    using Finished = std::function<void(const QVariant &result)>;
+
+    static TaskExecutor *instance();
+
+    explicit TaskExecutor(QObject *parent = nullptr);
+    virtual ~TaskExecutor() override;
+
+    int submit(const PluginId &pluginId, const InstanceId &instanceId, QObject *context,
+               const Task &task, const Finished &finished);
+    // 未开始的任务不再执行，执行中的任务结果被丢弃
+    bool cancel(const int taskId);
+    void cancelAll(const InstanceId &instanceId);
+
+    int pluginConcurrency() const;
+    void setPluginConcurrency(const int count);
+    int maxThreadCount() const;
+    int pendingCount(const PluginId &pluginId) const;
+    bool waitForDone(const int msecs = -1);
+
+private:
+    struct TaskInfo {
+        PluginId pluginId;
+        InstanceId instanceId;
+        QPointer<QObject> context;
+        Task task;
+        Finished finished;
+        bool isRunning = false;
+        bool isCanceled = false;
+    };
+    struct PluginStats {
+        QQueue<int> queued;
+        int running = 0;
+        int finished = 0;
+        int canceled = 0;
+    };
+
+    friend class TaskRunnable;
+    void startNext(const PluginId &pluginId);
+    void finish(const int taskId, const QVariant &result);
+    void reportStats(const PluginId &pluginId) const;
+
+    QThreadPool m_pool;
+    QHash<int, TaskInfo> m_tasks;
+    QHash<PluginId, PluginStats> m_stats;
+    int m_nextId = 1;
+    int m_pluginConcurrency = 2;
+};
+WIDGETS_FRAME_END_NAMESPACE
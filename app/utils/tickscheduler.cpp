@@ -0,0 +1,209 @@
+/*
+ * Copyright (C) 2022 UnionTech Technology Co., Ltd.
+ *
+ * Author:     yeshanshan <yeshanshan@uniontech.com>
+ *
+ * Maintainer: yeshanshan <yeshanshan@uniontech.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "tickscheduler.h"
+#include <widgetsinterface.h>
+
+#include <QDateTime>
+#include <QTimerEvent>
+#include <QDebug>
+
+#include <limits>
+
+WIDGETS_USE_NAMESPACE
+WIDGETS_FRAME_BEGIN_NAMESPACE
+// 相差在此范围内的到期时间合并到同一次唤醒中
+static const int MergeTolerance = 20;
+static const int MinInterval = 100;
+
+TickScheduler *TickScheduler::instance()
+{
+    static TickScheduler *g_scheduler = nullptr;
+    if (!g_scheduler)
+        g_scheduler = new TickScheduler();
+    return g_scheduler;
+}
+
+TickScheduler::TickScheduler(QObject *parent)
+    : QObject(parent)
+{
+}
+
+TickScheduler::~TickScheduler()
+{
+    m_timer.stop();
+}
+
+int TickScheduler::subscribe(const InstanceId &instanceId, const int interval, QObject *context, const Callback &callback)
+{
+    if (!context || !callback)
+        return -1;
+
+    Subscription subscription;
+    subscription.instanceId = instanceId;
+    subscription.interval = qMax(interval, MinInterval);
+    subscription.context = context;
+    subscription.callback = callback;
+    subscription.deadline = nextAlignedTime(QDateTime::currentMSecsSinceEpoch(), subscription.interval);
+
+    const int tickId = m_nextId++;
+    m_subscriptions.insert(tickId, subscription);
+    qDebug(dwLog()) << "subscribe tick" << instanceId << subscription.interval << tickId;
+
+    schedule();
+    return tickId;
+}
+
+void TickScheduler::unsubscribe(const int tickId)
+{
+    if (m_subscriptions.remove(tickId) > 0)
+        schedule();
+}
+
+void TickScheduler::unsubscribeAll(const InstanceId &instanceId)
+{
+    for (auto iter = m_subscriptions.begin(); iter != m_subscriptions.end();) {
+        if (iter->instanceId == instanceId) {
+            iter = m_subscriptions.erase(iter);
+        } else {
+            ++iter;
+        }
+    }
+    m_pausedInstances.remove(instanceId);
+    schedule();
+}
+
+int TickScheduler::count() const
+{
+    return m_subscriptions.count();
+}
+
+bool TickScheduler::isPaused() const
+{
+    return m_paused;
+}
+
+void TickScheduler::setPaused(const bool paused)
+{
+    if (m_paused == paused)
+        return;
+
+    m_paused = paused;
+    if (m_paused) {
+        m_timer.stop();
+        return;
+    }
+    dispatch(true);
+}
+
+bool TickScheduler::isInstancePaused(const InstanceId &instanceId) const
+{
+    return m_pausedInstances.contains(instanceId);
+}
+
+void TickScheduler::setInstancePaused(const InstanceId &instanceId, const bool paused)
+{
+    if (paused == m_pausedInstances.contains(instanceId))
+        return;
+
+    if (paused) {
+        m_pausedInstances.insert(instanceId);
+        schedule();
+        return;
+    }
+    m_pausedInstances.remove(instanceId);
+    if (m_paused)
+        return;
+    dispatch(false, instanceId);
+}
+
+qint64 TickScheduler::nextAlignedTime(const qint64 now, const int interval)
+{
+    if (interval <= 0)
+        return now;
+
+    return (now / interval + 1) * interval;
+}
+
+void TickScheduler::timerEvent(QTimerEvent *event)
+{
+    if (event->timerId() == m_timer.timerId()) {
+        m_timer.stop();
+        dispatch();
+    }
+    QObject::timerEvent(event);
+}
+
+void TickScheduler::dispatch(const bool force, const InstanceId &forceInstance)
+{
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+    // 回调中可能会取消订阅，先记录本次到期的订阅
+    QList<int> dueIds;
+    for (auto iter = m_subscriptions.begin(); iter != m_subscriptions.end();) {
+        if (!iter->context) {
+            iter = m_subscriptions.erase(iter);
+            continue;
+        }
+        if (m_pausedInstances.contains(iter->instanceId)) {
+            ++iter;
+            continue;
+        }
+        const bool isForced = force || (!forceInstance.isEmpty() && iter->instanceId == forceInstance);
+        if (isForced || iter->deadline <= now + MergeTolerance) {
+            iter->deadline = nextAlignedTime(now + MergeTolerance, iter->interval);
+            dueIds << iter.key();
+        }
+        ++iter;
+    }
+
+    for (const auto tickId : qAsConst(dueIds)) {
+        auto iter = m_subscriptions.constFind(tickId);
+        if (iter == m_subscriptions.constEnd() || !iter->context)
+            continue;
+        // 回调可能修改订阅表，复制后再调用
+        const Callback callback = iter->callback;
+        callback();
+    }
+
+    schedule();
+}
+
+void TickScheduler::schedule()
+{
+    if (m_paused || m_subscriptions.isEmpty()) {
+        m_timer.stop();
+        return;
+    }
+
+    qint64 deadline = std::numeric_limits<qint64>::max();
+    for (const auto &subscription : qAsConst(m_subscriptions)) {
+        if (!m_pausedInstances.contains(subscription.instanceId))
+            deadline = qMin(deadline, subscription.deadline);
+    }
+    if (deadline == std::numeric_limits<qint64>::max()) {
+        m_timer.stop();
+        return;
+    }
+
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+    m_timer.start(static_cast<int>(qMax<qint64>(0, deadline - now)), Qt::PreciseTimer, this);
+}
+WIDGETS_FRAME_END_NAMESPACE
@@ -0,0 +1,86 @@
+/*
+ * Copyright (C) 2022 UnionTech Technology Co., Ltd.
+ *
+ * Author:     yeshanshan <yeshanshan@uniontech.com>
+ *
+ * Maintainer: yeshanshan <yeshanshan@uniontech.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "global.h"
+#include <QObject>
+#include <QBasicTimer>
+#include <QMap>
+#include <QPointer>
+#include <QSet>
+
+#include <functional>
+
+WIDGETS_FRAME_BEGIN_NAMESPACE
+/**
+ * @brief 组件共享的定时器，回调时间与系统时钟对齐，同一时刻到期的回调在一次唤醒中执行，
+ * 面板或组件不可见时暂停。
+ */
+class TickScheduler : public QObject
+{
+    Q_OBJECT
+public:
+    using Callback = std::function<void()>;
+
+    static TickScheduler *instance();
+
+    explicit TickScheduler(QObject *parent = nullptr);
+    virtual ~TickScheduler() override;
+
+    int subscribe(const InstanceId &instanceId, const int interval, QObject *context, const Callback &callback);
+    void unsubscribe(const int tickId);
+    void unsubscribeAll(const InstanceId &instanceId);
+    int count() const;
+
+    bool isPaused() const;
+    // 恢复时立即回调一次，避免显示过期的内容
+    void setPaused(const bool paused);
+    // 组件不可见时单独暂停
+    bool isInstancePaused(const InstanceId &instanceId) const;
+    void setInstancePaused(const InstanceId &instanceId, const bool paused);
+
+    // 下一个与系统时钟对齐的时刻，单位毫秒
+    static qint64 nextAlignedTime(const qint64 now, const int interval);
+
+protected:
+    virtual void timerEvent(QTimerEvent *event) override;
+
+private:
+    struct Subscription {
+        InstanceId instanceId;
+        int interval = 0;
+        QPointer<QObject> context;
+        Callback callback;
+        qint64 deadline = 0;
+    };
+
+    void dispatch(const bool force = false, const InstanceId &forceInstance = InstanceId());
+    void schedule();
+
+    QMap<int, Subscription> m_subscriptions;
+    QSet<InstanceId> m_pausedInstances;
+    QBasicTimer m_timer;
+    int m_nextId = 1;
+    // 面板初始为收起状态
+    bool m_paused = true;
+};
+WIDGETS_FRAME_END_NAMESPACE
@@ -0,0 +1,184 @@
+/*
+ * Copyright (C) 2022 UnionTech Technology Co., Ltd.
+ *
+ * Author:     yeshanshan <yeshanshan@uniontech.com>
+ *
+ * Maintainer: yeshanshan <yeshanshan@uniontech.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "viewsnapshot.h"
+#include "roundedcornercache.h"
+
+#include <QChildEvent>
+#include <QEvent>
+#include <QTimerEvent>
+#include <QWidget>
+
+WIDGETS_FRAME_BEGIN_NAMESPACE
+// 持续重绘的组件（如时钟）在鼠标停留期间最多按该间隔截图一次。
+static const int IdleRenderInterval = 200;
+
+ViewSnapshot::ViewSnapshot(QWidget *owner)
+    : QObject(owner)
+    , m_owner(owner)
+{
+    // 拖拽前鼠标一定会先进入单元格并按下，在此之前准备好快照
+    if (m_owner)
+        m_owner->installEventFilter(this);
+}
+
+void ViewSnapshot::setView(QWidget *view, const bool isUserAreaInstance)
+{
+    if (m_view == view && m_isUserAreaInstance == isUserAreaInstance)
+        return;
+
+    if (m_view) {
+        m_view->removeEventFilter(this);
+        for (auto child : m_view->findChildren<QWidget *>())
+            child->removeEventFilter(this);
+    }
+
+    m_view = view;
+    m_isUserAreaInstance = isUserAreaInstance;
+    m_source = QPixmap();
+    m_pixmap = QPixmap();
+    m_dirty = true;
+
+    if (m_view)
+        track(m_view);
+}
+
+QPixmap ViewSnapshot::pixmap()
+{
+    if (m_source.isNull())
+        render();
+
+    if (m_pixmap.isNull())
+        m_pixmap = RoundedCornerCache::rounded(m_source, m_isUserAreaInstance);
+
+    return m_pixmap;
+}
+
+void ViewSnapshot::setSnapshot(const QPixmap &pixmap)
+{
+    // 仅保存截图，圆角裁剪推迟到真正使用时。
+    m_source = pixmap;
+    m_pixmap = QPixmap();
+    m_dirty = false;
+    m_idleRender.stop();
+}
+
+bool ViewSnapshot::isDirty() const
+{
+    return m_dirty;
+}
+
+void ViewSnapshot::invalidate()
+{
+    m_dirty = true;
+    if (m_hovered)
+        scheduleRender();
+}
+
+bool ViewSnapshot::eventFilter(QObject *watched, QEvent *event)
+{
+    // 长按才开始拖拽，按下时截图不会推迟拖拽开始；按下的可能是视图中的子控件
+    if (event->type() == QEvent::MouseButtonPress) {
+        if (m_dirty && canRender())
+            render();
+        return QObject::eventFilter(watched, event);
+    }
+
+    if (watched == m_owner) {
+        switch (event->type()) {
+        case QEvent::Enter:
+            m_hovered = true;
+            if (m_dirty)
+                scheduleRender();
+            break;
+        case QEvent::Leave:
+            m_hovered = false;
+            m_idleRender.stop();
+            break;
+        default:
+            break;
+        }
+        return QObject::eventFilter(watched, event);
+    }
+
+    if (!m_rendering) {
+        switch (event->type()) {
+        case QEvent::Paint:
+        case QEvent::Resize:
+            invalidate();
+            break;
+        case QEvent::ChildAdded:
+            if (auto child = qobject_cast<QWidget *>(static_cast<QChildEvent *>(event)->child()))
+                track(child);
+            break;
+        default:
+            break;
+        }
+    }
+    return QObject::eventFilter(watched, event);
+}
+
+void ViewSnapshot::timerEvent(QTimerEvent *event)
+{
+    do {
+        if (event->timerId() != m_idleRender.timerId())
+            break;
+
+        m_idleRender.stop();
+        if (m_dirty && canRender())
+            render();
+    } while (false);
+
+    return QObject::timerEvent(event);
+}
+
+void ViewSnapshot::track(QWidget *widget)
+{
+    widget->installEventFilter(this);
+    for (auto child : widget->findChildren<QWidget *>())
+        child->installEventFilter(this);
+}
+
+bool ViewSnapshot::canRender() const
+{
+    // 同一个视图会在编辑和显示面板间切换，仅由当前持有它的单元格生成快照。
+    return m_view && m_view->isVisible() && m_owner && m_owner->isAncestorOf(m_view);
+}
+
+void ViewSnapshot::render()
+{
+    if (!m_view)
+        return;
+
+    m_rendering = true;
+    m_source = m_view->grab();
+    m_pixmap = RoundedCornerCache::rounded(m_source, m_isUserAreaInstance);
+    m_rendering = false;
+    m_dirty = false;
+}
+
+void ViewSnapshot::scheduleRender()
+{
+    // 不重新计时，避免持续重绘的视图一直得不到刷新
+    if (!m_idleRender.isActive() && canRender())
+        m_idleRender.start(IdleRenderInterval, this);
+}
+WIDGETS_FRAME_END_NAMESPACE
@@ -0,0 +1,71 @@
+/*
+ * Copyright (C) 2022 UnionTech Technology Co., Ltd.
+ *
+ * Author:     yeshanshan <yeshanshan@uniontech.com>
+ *
+ * Maintainer: yeshanshan <yeshanshan@uniontech.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "global.h"
+#include <QBasicTimer>
+#include <QObject>
+#include <QPixmap>
+#include <QPointer>
+
+class QWidget;
+WIDGETS_FRAME_BEGIN_NAMESPACE
+/**
+ * @brief 组件视图的圆角快照缓存，视图重绘时只标记失效。
+ * 鼠标停留在单元格上时空闲重新生成，按下时补齐，拖拽开始时直接使用已有的快照。
+ */
+class ViewSnapshot : public QObject
+{
+    Q_OBJECT
+public:
+    explicit ViewSnapshot(QWidget *owner);
+
+    void setView(QWidget *view, const bool isUserAreaInstance);
+
+    // 已有快照时直接返回，只有从未生成过时才同步截图。
+    QPixmap pixmap();
+    // 使用外部已经得到的截图作为快照，避免重复grab。
+    void setSnapshot(const QPixmap &pixmap);
+    bool isDirty() const;
+    void invalidate();
+
+protected:
+    virtual bool eventFilter(QObject *watched, QEvent *event) override;
+    virtual void timerEvent(QTimerEvent *event) override;
+
+private:
+    void track(QWidget *widget);
+    bool canRender() const;
+    void render();
+    void scheduleRender();
+
+    QPointer<QWidget> m_owner;
+    QPointer<QWidget> m_view;
+    bool m_isUserAreaInstance = false;
+    QPixmap m_source;
+    QPixmap m_pixmap;
+    bool m_dirty = true;
+    bool m_rendering = false;
+    bool m_hovered = false;
+    QBasicTimer m_idleRender;
+};
+WIDGETS_FRAME_END_NAMESPACE
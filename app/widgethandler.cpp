@@ -20,6 +20,9 @@
  */
 
 #include "widgethandler.h"
+#include "tickscheduler.h"
+#include "taskexecutor.h"
+#include "memoryaccountant.h"
 #include <QSettings>
 #include <QDebug>
 #include <QCoreApplication>
@@ -99,6 +102,38 @@ WidgetHandlerImpl::WidgetHandlerImpl()
 
 WidgetHandlerImpl::~WidgetHandlerImpl()
 {
+    TickScheduler::instance()->unsubscribeAll(m_id);
+    TaskExecutor::instance()->cancelAll(m_id);
+}
+
+int WidgetHandlerImpl::subscribeTick(const int interval, QObject *context, const std::function<void ()> &callback)
+{
+    const auto pluginId = m_pluginId;
+    return TickScheduler::instance()->subscribe(m_id, interval, context, [pluginId, callback]() {
+        MemoryScope scope(pluginId);
+        callback();
+    });
+}
+
+void WidgetHandlerImpl::unsubscribeTick(const int tickId)
+{
+    TickScheduler::instance()->unsubscribe(tickId);
+}
+
+int WidgetHandlerImpl::submitTask(QObject *context, const std::function<QVariant ()> &task,
+                                  const std::function<void (const QVariant &)> &finished)
+{
+    const auto pluginId = m_pluginId;
+    return TaskExecutor::instance()->submit(m_pluginId, m_id, context, task, [pluginId, finished](const QVariant &result) {
+        MemoryScope scope(pluginId);
+        if (finished)
+            finished(result);
+    });
+}
+
+void WidgetHandlerImpl::cancelTask(const int taskId)
+{
+    TaskExecutor::instance()->cancel(taskId);
 }
 
 QVariant WidgetHandlerImpl::value(const QString &key, const QVariant &defaultValue) const
@@ -41,6 +41,11 @@ public:
     virtual QString pluginId() const override { return m_pluginId;}
     virtual IWidget::Type type() const override { return m_type;}
     virtual QSize size() const override;
+    virtual int subscribeTick(const int interval, QObject *context, const std::function<void()> &callback) override;
+    virtual void unsubscribeTick(const int tickId) override;
+    virtual int submitTask(QObject *context, const std::function<QVariant()> &task,
+                           const std::function<void(const QVariant &)> &finished) override;
+    virtual void cancelTask(const int taskId) override;
     static QSize size(const IWidget::Type type, const bool instance = true);
     QString typeString() const;
     static QString typeString(const Widgets::IWidget::Type type);
@@ -23,6 +23,7 @@
 #include "pluginspec.h"
 #include "widgethandler.h"
 #include "instanceproxy.h"
+#include "memoryaccountant.h"
 
 #include <QPluginLoader>
 #include <QDir>
@@ -286,11 +287,11 @@ QList<PluginPath> WidgetManager::addingPlugins()
     const QList<PluginId> prePluginIds = m_plugins.keys();
 
     for (QString fileName : pluginPaths()) {
+        if (prePluginIds.contains(parsePluginInfo(fileName, false).id))
+            continue;
+
         const auto &info = parsePluginInfo(fileName);
         if (info.plugin) {
-            if (prePluginIds.contains(info.id)) {
-                continue;
-            }
             auto spec = loadPlugin(info);
             qDebug(dwLog()) << "load new plugin [" << spec->id() << "] successful." << fileName;
 
@@ -335,6 +336,12 @@ QList<Instance *> WidgetManager::createWidgetStoreInstances(const PluginId &key)
 
 WidgetPluginSpec *WidgetManager::loadPlugin(const PluginPath &pluginPath)
 {
+    // 已加载的插件不再重复加载，避免多个loader持有同一个动态库
+    for (auto plugin : qAsConst(m_plugins)) {
+        if (plugin->m_fileName == pluginPath)
+            return plugin;
+    }
+
     const auto info = parsePluginInfo(pluginPath);
     if (info.plugin) {
         return loadPlugin(info);
@@ -352,22 +359,25 @@ WidgetPluginSpec *WidgetManager::loadPlugin(const PluginInfo &info)
     qDebug(dwLog()) << "loadPlugin() config's filePath:" << store->fileName();
     spec->setDataStore(store);
     m_plugins.insert(spec->id(), spec);
+    if (info.memoryBudget > 0)
+        MemoryAccountant::instance()->setBudget(spec->id(), info.memoryBudget);
 
     return spec;
 }
 
 bool WidgetManager::isPlugin(const QString &fileName) const
 {
-    const auto &info = parsePluginInfo(fileName);
-    return info.plugin;
+    // 只检查元数据，避免重新加载已卸载的插件
+    const auto &info = parsePluginInfo(fileName, false);
+    return !info.fileName.isEmpty();
 }
 
-PluginInfo WidgetManager::parsePluginInfo(const QString &fileName) const
+PluginInfo WidgetManager::parsePluginInfo(const QString &fileName, const bool load) const
 {
     PluginInfo info;
 
-    QPluginLoader loader(fileName);
-    const auto &meta = loader.metaData();
+    QScopedPointer<QPluginLoader> loader(new QPluginLoader(fileName));
+    const auto &meta = loader->metaData();
 
     do {
         const auto iid = meta["IID"].toString();
@@ -387,20 +397,29 @@ PluginInfo WidgetManager::parsePluginInfo(const QString &fileName) const
             qWarning(dwLog()) << QString("plugin version [%1] is not matched by [%2].").arg(info.version).arg(currentVersion()) << fileName;
             break;
         }
-        if (!loader.instance()) {
-            qWarning(dwLog()) << "load the plugin error." << loader.errorString();
+        // 单位为KB
+        info.memoryBudget = meta["MetaData"]["memoryBudget"].toVariant().toLongLong() * 1024;
+        info.unloadWhenIdle = meta["MetaData"]["unloadWhenIdle"].toBool();
+        if (!load) {
+            info.fileName = fileName;
+            break;
+        }
+        if (!loader->instance()) {
+            qWarning(dwLog()) << "load the plugin error." << loader->errorString();
             break;
         }
-        info.plugin = qobject_cast<IWidgetPlugin *>(loader.instance());
+        info.plugin = qobject_cast<IWidgetPlugin *>(loader->instance());
         if (!info.plugin) {
             qWarning(dwLog()) << "the plugin isn't a IWidgetPlugin." << fileName;
             break;
         }
         info.fileName = fileName;
+        // 每个loader的加载都需要对应一次卸载，只保留加载成功的loader
+        info.loader = loader.take();
     } while (false);
 
-    if (!info.plugin) {
-        loader.unload();
+    if (load && !info.plugin) {
+        loader->unload();
     }
 
     return info;
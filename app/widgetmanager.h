@@ -67,7 +67,7 @@ public:
     QString dataStorePath(const PluginId &pluginId) const;
 
     WidgetPluginSpec *loadPlugin(const PluginPath &pluginPath);
-    PluginInfo parsePluginInfo(const QString &fileName) const;
+    PluginInfo parsePluginInfo(const QString &fileName, const bool load = true) const;
     WidgetPluginSpec *loadPlugin(const PluginInfo &info);
     bool isPlugin(const QString &fileName) const;
     QList<PluginId> removingPlugins() const;
@@ -0,0 +1,49 @@
+/*
+ * Copyright (C) 2022 UnionTech Technology Co., Ltd.
+ *
+ * Author:     yeshanshan <yeshanshan@uniontech.com>
+ *
+ * Maintainer: yeshanshan <yeshanshan@uniontech.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "widgetsapplication.h"
+#include "memoryaccountant.h"
+
+#include <QThread>
+
+WIDGETS_FRAME_BEGIN_NAMESPACE
+
+WidgetsApplication::WidgetsApplication(int &argc, char **argv)
+    : DApplication(argc, argv)
+{
+    // 统计器只在主线程中使用，提前创建
+    MemoryAccountant::instance();
+}
+
+bool WidgetsApplication::notify(QObject *receiver, QEvent *event)
+{
+    auto accountant = MemoryAccountant::instance();
+    if (accountant->isEnabled() && QThread::currentThread() == thread()) {
+        const PluginId &pluginId = accountant->ownerOf(receiver);
+        if (!pluginId.isEmpty()) {
+            MemoryScope scope(pluginId);
+            return DApplication::notify(receiver, event);
+        }
+    }
+    return DApplication::notify(receiver, event);
+}
+
+WIDGETS_FRAME_END_NAMESPACE
@@ -0,0 +1,40 @@
+/*
+ * Copyright (C) 2022 UnionTech Technology Co., Ltd.
+ *
+ * Author:     yeshanshan <yeshanshan@uniontech.com>
+ *
+ * Maintainer: yeshanshan <yeshanshan@uniontech.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "global.h"
+#include <DApplication>
+
+DWIDGET_USE_NAMESPACE
+WIDGETS_FRAME_BEGIN_NAMESPACE
+/**
+ * @brief 开启内存统计时，投递给插件对象树的事件在该插件的统计区间内处理
+ */
+class WidgetsApplication : public DApplication
+{
+    Q_OBJECT
+public:
+    WidgetsApplication(int &argc, char **argv);
+
+    virtual bool notify(QObject *receiver, QEvent *event) override;
+};
+WIDGETS_FRAME_END_NAMESPACE
@@ -24,17 +24,30 @@
 #include "mainview.h"
 #include "displaymodepanel.h"
 #include "instancemodel.h"
+#include "framerecorder.h"
+#include "memoryaccountant.h"
+#include "animationviewcontainer.h"
 #include "dbusserver_adaptor.h"
+#include <widgetspixmapcache.h>
 #include <QDebug>
+#include <QJsonDocument>
+
+#include <DGuiApplicationHelper>
 
 #define DDE_WIDGETS_SERVICE "org.deepin.dde.Widgets1"
 
+static const int RequestCoalesceInterval = 50;
+
+DGUI_USE_NAMESPACE
 WIDGETS_FRAME_USE_NAMESPACE
 WidgetsServer::WidgetsServer(QObject *parent)
     : QObject (parent)
     , m_manager (new WidgetManager())
 {
-
+    bool ok = false;
+    const int interval = qEnvironmentVariableIntValue("DDE_WIDGETS_HIBERNATE_INTERVAL", &ok);
+    if (ok && interval > 0)
+        m_hibernateInterval = interval * 1000;
 }
 
 WidgetsServer::~WidgetsServer()
@@ -65,40 +78,103 @@ bool WidgetsServer::registerService()
 
 void WidgetsServer::start()
 {
+    connect(MemoryAccountant::instance(), &MemoryAccountant::budgetExceeded, this,
+            [this](const PluginId &pluginId, const qint64 liveBytes) {
+        Q_EMIT MemoryBudgetExceeded(pluginId, liveBytes);
+    });
+    // 主题切换后缓存的图标都已过期
+    connect(DGuiApplicationHelper::instance(), &DGuiApplicationHelper::themeTypeChanged,
+            PixmapCache::instance(), &PixmapCache::clear);
     m_manager->loadPlugins();
 //    Show();
 }
 
 void WidgetsServer::Toggle()
 {
-    if (m_mainView && m_mainView->isVisible()) {
-        Hide();
-    } else {
-        Show();
-    }
+    qDebug(dwLog()) << "Toggle";
+    // 合并连续的请求，以最后的目标状态为准
+    requestVisible(!(m_pendingVisible >= 0 ? m_pendingVisible : isViewVisible()));
 }
 
 void WidgetsServer::Show()
 {
     qDebug(dwLog()) << "Show";
+    requestVisible(true);
+}
+
+void WidgetsServer::Hide()
+{
+    qDebug(dwLog()) << "Hide";
+    requestVisible(false);
+}
+
+bool WidgetsServer::isViewVisible() const
+{
+    if (!m_mainView)
+        return false;
+
+    const auto state = m_mainView->visibilityState();
+    return state == AnimationViewContainer::Showing || state == AnimationViewContainer::Shown;
+}
+
+bool WidgetsServer::isTransitioning() const
+{
+    if (m_visibleTimer.isActive())
+        return true;
+    if (!m_mainView)
+        return false;
+
+    const auto state = m_mainView->visibilityState();
+    return state == AnimationViewContainer::Showing || state == AnimationViewContainer::Hiding;
+}
+
+void WidgetsServer::requestVisible(const bool visible)
+{
+    m_pendingVisible = visible;
+    // 空闲时立即响应，只合并动画过程中到来的请求
+    if (!isTransitioning()) {
+        applyVisible();
+        return;
+    }
+    m_visibleTimer.start(RequestCoalesceInterval, this);
+}
+
+void WidgetsServer::applyVisible()
+{
+    const bool visible = m_pendingVisible > 0;
+    m_pendingVisible = -1;
+
+    if (!visible) {
+        if (m_mainView)
+            m_mainView->hideView();
+        return;
+    }
+
+    // 已经展开时重复的Show()不做任何事
+    if (m_mainView && m_mainView->visibilityState() == AnimationViewContainer::Shown)
+        return;
+
     if (!m_mainView) {
         m_mainView = new MainView(m_manager);
+        connect(m_mainView, &MainView::visibilityChanged, this, &WidgetsServer::VisibilityChanged);
+        m_mainView->setHibernateInterval(m_hibernateInterval);
 
         m_mainView->init();
     }
 
-    m_mainView->switchToDisplayMode();
+    // 只在完全收起后重新展开时回到显示模式，反转收起动画时保持原样
+    if (m_mainView->visibilityState() == AnimationViewContainer::Hidden)
+        m_mainView->switchToDisplayMode();
     m_mainView->showView();
 }
 
-void WidgetsServer::Hide()
+void WidgetsServer::timerEvent(QTimerEvent *event)
 {
-    qDebug(dwLog()) << "Hide";
-    if (!m_mainView) {
-        return;
+    if (event->timerId() == m_visibleTimer.timerId()) {
+        m_visibleTimer.stop();
+        applyVisible();
     }
-
-    m_mainView->hideView();
+    QObject::timerEvent(event);
 }
 
 void WidgetsServer::SyncWidgets()
@@ -116,3 +192,48 @@ void WidgetsServer::SyncWidgets()
     qDebug(dwLog()) << " removedPlugins:" << removedPluginIds
                     << "addedPlugins:" << addedPluginIds;
 }
+
+void WidgetsServer::SetFrameRecorderEnabled(bool enabled)
+{
+    qDebug(dwLog()) << "SetFrameRecorderEnabled" << enabled;
+    if (!m_frameRecorder) {
+        if (!enabled)
+            return;
+        m_frameRecorder = new FrameRecorder(this);
+    }
+    m_frameRecorder->setEnabled(enabled);
+}
+
+QString WidgetsServer::FrameRecorderReport()
+{
+    if (!m_frameRecorder)
+        return QString();
+
+    return m_frameRecorder->report();
+}
+
+void WidgetsServer::SetMemoryAccountingEnabled(bool enabled)
+{
+    qDebug(dwLog()) << "SetMemoryAccountingEnabled" << enabled;
+    MemoryAccountant::instance()->setEnabled(enabled);
+}
+
+QString WidgetsServer::MemoryReport()
+{
+    const auto &report = MemoryAccountant::instance()->report(m_manager->instances());
+    return QJsonDocument(report).toJson(QJsonDocument::Compact);
+}
+
+void WidgetsServer::SetHibernateInterval(int seconds)
+{
+    qDebug(dwLog()) << "SetHibernateInterval" << seconds;
+    m_hibernateInterval = qMax(0, seconds) * 1000;
+    if (m_mainView)
+        m_mainView->setHibernateInterval(m_hibernateInterval);
+}
+
+void WidgetsServer::SetMemoryBudget(const QString &pluginId, qint64 bytes)
+{
+    qDebug(dwLog()) << "SetMemoryBudget" << pluginId << bytes;
+    MemoryAccountant::instance()->setBudget(pluginId, bytes);
+}
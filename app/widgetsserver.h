@@ -24,10 +24,12 @@
 #include "global.h"
 #include <QObject>
 #include <QEvent>
+#include <QBasicTimer>
 
 WIDGETS_FRAME_BEGIN_NAMESPACE
 class WidgetManager;
 class MainView;
+class FrameRecorder;
 WIDGETS_FRAME_END_NAMESPACE
 class WidgetsServer : public QObject {
     Q_OBJECT
@@ -44,8 +46,33 @@ public Q_SLOTS:
     void Show();
     void Hide();
     void SyncWidgets();
+    void SetFrameRecorderEnabled(bool enabled);
+    QString FrameRecorderReport();
+    void SetMemoryAccountingEnabled(bool enabled);
+    QString MemoryReport();
+    void SetMemoryBudget(const QString &pluginId, qint64 bytes);
+    // 面板收起多少秒后组件休眠，0表示不休眠
+    void SetHibernateInterval(int seconds);
+
+Q_SIGNALS:
+    // AnimationViewContainer::VisibilityState, Hidden(0) Showing(1) Shown(2) Hiding(3)
+    void VisibilityChanged(int state);
+    void MemoryBudgetExceeded(const QString &pluginId, qint64 liveBytes);
+
+protected:
+    virtual void timerEvent(QTimerEvent *event) override;
 
 private:
+    bool isViewVisible() const;
+    bool isTransitioning() const;
+    void requestVisible(const bool visible);
+    void applyVisible();
+
     WIDGETS_FRAME_NAMESPACE::WidgetManager *m_manager;
     WIDGETS_FRAME_NAMESPACE::MainView *m_mainView = nullptr;
+    WIDGETS_FRAME_NAMESPACE::FrameRecorder *m_frameRecorder = nullptr;
+    QBasicTimer m_visibleTimer;
+    // -1 表示没有待处理的请求
+    int m_pendingVisible = -1;
+    int m_hibernateInterval = 0;
 };
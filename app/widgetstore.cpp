@@ -25,6 +25,8 @@
 #include "widgetmanager.h"
 #include "instanceproxy.h"
 #include "utils.h"
+#include "roundedcornercache.h"
+#include "viewsnapshot.h"
 
 #include <QScrollArea>
 #include <QDebug>
@@ -42,6 +44,8 @@
 #include <DButtonBox>
 
 WIDGETS_FRAME_BEGIN_NAMESPACE
+static const int ReleasePreviewsInterval = 60 * 1000;
+
 WidgetStore::WidgetStore(WidgetManager *manager, QWidget *parent)
     : QWidget(parent)
     , m_manager(manager)
@@ -93,9 +97,14 @@ QScrollArea *WidgetStore::scrollView()
 
 void WidgetStore::addPlugin(const PluginId &pluginId)
 {
+    // 未加载预览时，新插件在下次加载预览时一起创建
+    if (!m_isPreviewsLoaded)
+        return;
+
     auto pluginCell = addPluginCell(pluginId);
     m_layout->addWidget(pluginCell);
     m_pluginCells.insert(pluginId, pluginCell);
+    Q_EMIT previewsChanged();
 }
 
 PluginCell *WidgetStore::addPluginCell(const PluginId &pluginId)
@@ -106,6 +115,7 @@ PluginCell *WidgetStore::addPluginCell(const PluginId &pluginId)
         auto view = instance->view();
         Q_ASSERT(view);
         auto cell = new WidgetStoreCell(instance->handler(), this);
+        cell->m_instance = instance;
         connect(cell, &WidgetStoreCell::addWidget, this, &WidgetStore::addWidget);
         cell->setView(view);
         pluginCell->addCell(cell);
@@ -114,6 +124,7 @@ PluginCell *WidgetStore::addPluginCell(const PluginId &pluginId)
     pluginCell->setDescription(plugin->description());
     const int selectedCell = 0;
     pluginCell->setChecked(selectedCell);
+    connect(pluginCell, &PluginCell::currentCellChanged, this, &WidgetStore::previewsChanged);
     return pluginCell;
 }
 
@@ -121,23 +132,110 @@ void WidgetStore::removePlugin(const PluginId &pluginId)
 {
     for (auto iter = m_pluginCells.begin(); iter != m_pluginCells.end();) {
         if (iter.key() == pluginId) {
-            m_layout->removeWidget(iter.value());
-            iter.value()->deleteLater();
+            removePluginCell(iter.value());
             iter = m_pluginCells.erase(iter);
+            Q_EMIT previewsChanged();
         } else {
             iter++;
         }
     }
 }
 
+QHash<Instance *, IWidget::VisibilityState> WidgetStore::previewStates() const
+{
+    QHash<Instance *, IWidget::VisibilityState> states;
+    const QWidget *viewport = m_scrollView ? m_scrollView->viewport() : nullptr;
+    for (auto pluginCell : m_pluginCells) {
+        for (auto cell : pluginCell->cells()) {
+            if (!cell->m_instance)
+                continue;
+
+            // 未选中的尺寸不显示
+            if (!cell->isVisibleTo(pluginCell)) {
+                states[cell->m_instance] = IWidget::Hidden;
+                continue;
+            }
+            bool visible = true;
+            if (viewport) {
+                const QRect rect(cell->mapTo(viewport, QPoint(0, 0)), cell->size());
+                visible = viewport->rect().intersects(rect);
+            }
+            states[cell->m_instance] = visible ? IWidget::Visible : IWidget::ScrolledOff;
+        }
+    }
+    return states;
+}
+
 void WidgetStore::load()
 {
+    m_layout->addStretch();
+}
+
+void WidgetStore::loadPreviews()
+{
+    m_releasePreviewsTimer.stop();
+    if (m_isPreviewsLoaded)
+        return;
+
+    m_isPreviewsLoaded = true;
     const auto plugins = m_manager->plugins(IWidgetPlugin::Normal);
+    int index = 0;
     for (auto plugin : plugins) {
         const auto pluginId = plugin->id();
-        addPlugin(pluginId);
+        auto pluginCell = addPluginCell(pluginId);
+        // 插在末尾的stretch之前
+        m_layout->insertWidget(index++, pluginCell);
+        m_pluginCells.insert(pluginId, pluginCell);
     }
-    m_layout->addStretch();
+    Q_EMIT previewsChanged();
+}
+
+void WidgetStore::scheduleReleasePreviews()
+{
+    if (m_isPreviewsLoaded)
+        m_releasePreviewsTimer.start(ReleasePreviewsInterval, this);
+}
+
+bool WidgetStore::isPreviewsLoaded() const
+{
+    return m_isPreviewsLoaded;
+}
+
+void WidgetStore::releasePreviews()
+{
+    m_releasePreviewsTimer.stop();
+    if (!m_isPreviewsLoaded)
+        return;
+
+    m_isPreviewsLoaded = false;
+    for (auto pluginCell : qAsConst(m_pluginCells))
+        removePluginCell(pluginCell);
+    m_pluginCells.clear();
+    Q_EMIT previewsChanged();
+}
+
+void WidgetStore::removePluginCell(PluginCell *pluginCell)
+{
+    m_layout->removeWidget(pluginCell);
+    pluginCell->deleteLater();
+    // 预览组件的视图由实例在插件的统计区间内释放，不随界面析构
+    for (auto cell : pluginCell->cells()) {
+        if (auto instance = cell->m_instance) {
+            cell->m_instance = nullptr;
+            instance->detachView();
+            m_manager->aboutToShutdown(instance);
+            instance->deleteLater();
+        }
+    }
+}
+
+void WidgetStore::timerEvent(QTimerEvent *event)
+{
+    if (event->timerId() == m_releasePreviewsTimer.timerId()) {
+        releasePreviews();
+        return;
+    }
+    return QWidget::timerEvent(event);
 }
 
 PluginCell::PluginCell(QWidget *parent)
@@ -180,6 +278,7 @@ PluginCell::PluginCell(QWidget *parent)
         Q_ASSERT(index >= 0 && index < m_layout->count());
 
         m_layout->setCurrentIndex(index);
+        Q_EMIT currentCellChanged(index);
     });
 
     layout->addWidget(views, 0, Qt::AlignHCenter);
@@ -222,6 +321,11 @@ void PluginCell::addCell(WidgetStoreCell *cell)
     m_layout->addWidget(cellView);
 }
 
+QVector<WidgetStoreCell *> PluginCell::cells() const
+{
+    return m_cells;
+}
+
 void PluginCell::setChecked(const int index, const bool checked)
 {
     if(index < 0 || index >= m_typeBox->buttonList().count())
@@ -247,6 +351,7 @@ bool PluginCell::eventFilter(QObject *watched, QEvent *event)
 WidgetStoreCell::WidgetStoreCell(WidgetHandler *handler, QWidget *parent)
     : DragDropWidget(parent)
     , m_handler(handler)
+    , m_snapshot(new ViewSnapshot(this))
 {
     setFocusPolicy(Qt::NoFocus);
 }
@@ -257,6 +362,7 @@ void WidgetStoreCell::setView(QWidget *view)
     m_view->setParent(this);
     m_view->setVisible(false);
     m_view->resize(m_handler->size());
+    m_snapshot->setView(m_view, WidgetHandlerImpl::get(m_handler)->m_isUserAreaInstance);
     const auto &targetSize = WidgetHandlerImpl::size(m_handler->type(), false);
 
     m_viewPlaceholder = new QLabel(this);
@@ -306,8 +412,8 @@ void WidgetStoreCell::startDrag(const QPoint &pos)
     dataStream << m_handler->pluginId() << m_handler->type() << hotSpot;
     mimeData->setData(EditModeMimeDataFormat, itemData);
 
-    QPixmap pixmap(child->grab());
-    pixmap.setMask(WidgetContainer::bitmapOfMask(pixmap.size(), WidgetHandlerImpl::get(m_handler)->m_isUserAreaInstance));
+    // the view is hidden and refreshed by placeholder's fresher, reuse it's grab.
+    const QPixmap &pixmap = m_snapshot->pixmap();
 
     QDrag *drag = new QDrag(this);
     drag->setMimeData(mimeData);
@@ -380,8 +486,9 @@ void WidgetStoreCell::updateViewPlaceholder()
 
     const auto &targetSize = m_viewPlaceholder->size();
     QPixmap pixmap = m_view->grab();
+    m_snapshot->setSnapshot(pixmap);
     pixmap = pixmap.scaled(targetSize, Qt::KeepAspectRatio, Qt::SmoothTransformation);
-    pixmap.setMask(WidgetContainer::bitmapOfMask(pixmap.size(), WidgetHandlerImpl::get(m_handler)->m_isUserAreaInstance));
+    pixmap = RoundedCornerCache::rounded(pixmap, WidgetHandlerImpl::get(m_handler)->m_isUserAreaInstance);
     m_viewPlaceholder->setPixmap(pixmap);
 
     update();
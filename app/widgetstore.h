@@ -24,6 +24,7 @@
 #include "global.h"
 #include "utils.h"
 #include <widgetsinterface.h>
+#include <QHash>
 
 #include <DBlurEffectWidget>
 DWIDGET_USE_NAMESPACE
@@ -39,6 +40,7 @@ DWIDGET_END_NAMESPACE
 WIDGETS_FRAME_BEGIN_NAMESPACE
 class WidgetManager;
 class WidgetStoreCell;
+class ViewSnapshot;
 class PluginCell : public DBlurEffectWidget {
     Q_OBJECT
 public:
@@ -47,6 +49,10 @@ public:
     void setDescription(const QString &text);
     void addCell(WidgetStoreCell *cell);
     void setChecked(const int index, const bool checked = true);
+    QVector<WidgetStoreCell *> cells() const;
+
+Q_SIGNALS:
+    void currentCellChanged(int index);
 
 protected:
     virtual bool eventFilter(QObject *watched, QEvent *event) override;
@@ -66,6 +72,7 @@ public:
     void setView(QWidget *view);
     QWidget *action() const;
     WidgetHandler *m_handler = nullptr;
+    Instance *m_instance = nullptr;
 
 Q_SIGNALS:
     void enterChanged(bool in);
@@ -88,6 +95,7 @@ private:
     QWidget *m_view = nullptr;
     QLabel *m_viewPlaceholder = nullptr;
     QBasicTimer m_viewPlaceholderFresher;
+    ViewSnapshot *m_snapshot = nullptr;
     QWidget *m_action = nullptr;
 };
 
@@ -101,16 +109,32 @@ public:
     void removePlugin(const PluginId &pluginId);
     QScrollArea *scrollView();
 
+    // 预览组件的可见状态，不计面板及模式
+    QHash<Instance *, IWidget::VisibilityState> previewStates() const;
+
+    // 预览组件在进入编辑模式时创建，离开编辑模式一段时间后释放，使插件可以被卸载
+    void loadPreviews();
+    void releasePreviews();
+    void scheduleReleasePreviews();
+    bool isPreviewsLoaded() const;
+
+protected:
+    virtual void timerEvent(QTimerEvent *event) override;
+
 private:
     void load();
     PluginCell *addPluginCell(const PluginId &pluginId);
+    void removePluginCell(PluginCell *pluginCell);
 Q_SIGNALS:
     void addWidget(const PluginId &pluginId, int type);
+    void previewsChanged();
 private:
     WidgetManager* m_manager = nullptr;
     QWidget *m_views = nullptr;
     QVBoxLayout *m_layout = nullptr;
     QMap<PluginId, PluginCell *> m_pluginCells;
     QScrollArea *m_scrollView = nullptr;
+    QBasicTimer m_releasePreviewsTimer;
+    bool m_isPreviewsLoaded = false;
 };
 WIDGETS_FRAME_END_NAMESPACE
@@ -0,0 +1,22 @@
+#!/bin/bash
+# 检查GUI线程中的阻塞DBus调用，需要保留的调用在行尾标注 "dbus-blocking-allowed"
+folders="./app ./notification ./memorymonitor ./worldclock ./interface ./common"
+allowed="dbus-blocking-allowed"
+result=0
+
+files=$(grep -rlE --include=*.cpp --include=*.h --include=*.hpp "QDBus" $folders | grep -v "/xml2cpp/")
+
+for file in $files; do
+    # QDBusInterface 构造时会同步introspect，其余为等待应答及同步调用
+    matches=$(grep -nE "QDBusInterface|waitForFinished\(|\.call\(|->call\(|QDBus::Block" "$file" | grep -v "$allowed")
+    if [ -n "$matches" ]; then
+        echo "$file:"
+        echo "$matches"
+        result=1
+    fi
+done
+
+if [ $result -ne 0 ]; then
+    echo "Blocking DBus calls found, please use DBusHelper in common/dbushelper.hpp instead."
+fi
+exit $result
@@ -0,0 +1,138 @@
+/*
+ * Copyright (C) 2022 UnionTech Technology Co., Ltd.
+ *
+ * Author:     yeshanshan <yeshanshan@uniontech.com>
+ *
+ * Maintainer: yeshanshan <yeshanshan@uniontech.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <QDBusConnection>
+#include <QDBusMessage>
+#include <QDBusPendingCallWatcher>
+#include <QDBusPendingReply>
+#include <QDBusVariant>
+#include <QDebug>
+#include <QVariantMap>
+
+#include <functional>
+
+/**
+ * @brief 异步DBus调用封装，创建时不做introspect，可作为成员长期持有。
+ * 回调在context所在线程执行，context销毁后不再回调。
+ * GUI线程中禁止阻塞等待DBus，由 check_blocking_dbus.sh 检查。
+ */
+class DBusHelper {
+public:
+    using ReplyCallback = std::function<void(const QDBusMessage &reply)>;
+    using PropertiesCallback = std::function<void(const QVariantMap &properties)>;
+
+    inline explicit DBusHelper(const QString &service, const QString &path, const QString &interface,
+                               const QDBusConnection &connection = QDBusConnection::sessionBus())
+        : m_service(service)
+        , m_path(path)
+        , m_interface(interface)
+        , m_connection(connection)
+    {
+    }
+
+    inline QString service() const { return m_service; }
+    inline QString path() const { return m_path; }
+    inline QString interface() const { return m_interface; }
+
+    inline void setTimeout(const int timeout) { m_timeout = timeout; }
+
+    /**
+     * @brief 调用方法，不关心返回值
+     */
+    inline void asyncCall(const QString &method, const QVariantList &arguments = QVariantList()) const
+    {
+        m_connection.asyncCall(methodCall(method, arguments), m_timeout);
+    }
+
+    /**
+     * @brief 调用方法，返回消息在回调中处理，出错时为ErrorMessage
+     */
+    inline void asyncCall(const QString &method, const QVariantList &arguments,
+                          QObject *context, const ReplyCallback &callback) const
+    {
+        watch(m_connection.asyncCall(methodCall(method, arguments), m_timeout), context, callback);
+    }
+
+    /**
+     * @brief 调用方法，按返回类型解析后在回调中处理
+     */
+    template<typename T>
+    inline void asyncCall(const QString &method, const QVariantList &arguments,
+                          QObject *context, const std::function<void(const QDBusPendingReply<T> &reply)> &callback) const
+    {
+        auto call = m_connection.asyncCall(methodCall(method, arguments), m_timeout);
+        auto watcher = new QDBusPendingCallWatcher(call, context);
+        QObject::connect(watcher, &QDBusPendingCallWatcher::finished, context, [callback](QDBusPendingCallWatcher *watcher) {
+            callback(QDBusPendingReply<T>(*watcher));
+            watcher->deleteLater();
+        });
+    }
+
+    /**
+     * @brief 获取接口的全部属性，复合类型需要通过qdbus_cast解析
+     */
+    inline void asyncProperties(QObject *context, const PropertiesCallback &callback) const
+    {
+        auto message = QDBusMessage::createMethodCall(m_service, m_path, "org.freedesktop.DBus.Properties", "GetAll");
+        message << m_interface;
+        const QString target(m_service + m_path);
+        watch(m_connection.asyncCall(message, m_timeout), context, [target, callback](const QDBusMessage &reply) {
+            if (reply.type() != QDBusMessage::ReplyMessage || reply.arguments().isEmpty()) {
+                qWarning() << "get properties error:" << target << reply.errorMessage();
+                return;
+            }
+            callback(qdbus_cast<QVariantMap>(reply.arguments().first()));
+        });
+    }
+
+    /**
+     * @brief 连接DBus信号
+     */
+    inline bool connect(const QString &signal, QObject *receiver, const char *slot) const
+    {
+        return m_connection.connect(m_service, m_path, m_interface, signal, receiver, slot);
+    }
+
+private:
+    inline QDBusMessage methodCall(const QString &method, const QVariantList &arguments) const
+    {
+        auto message = QDBusMessage::createMethodCall(m_service, m_path, m_interface, method);
+        message.setArguments(arguments);
+        return message;
+    }
+
+    inline static void watch(const QDBusPendingCall &call, QObject *context, const ReplyCallback &callback)
+    {
+        auto watcher = new QDBusPendingCallWatcher(call, context);
+        QObject::connect(watcher, &QDBusPendingCallWatcher::finished, context, [callback](QDBusPendingCallWatcher *watcher) {
+            callback(watcher->reply());
+            watcher->deleteLater();
+        });
+    }
+
+    QString m_service;
+    QString m_path;
+    QString m_interface;
+    QDBusConnection m_connection;
+    int m_timeout = -1;
+};
@@ -0,0 +1,109 @@
+/*
+ * Copyright (C) 2022 UnionTech Technology Co., Ltd.
+ *
+ * Author:     yeshanshan <yeshanshan@uniontech.com>
+ *
+ * Maintainer: yeshanshan <yeshanshan@uniontech.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "widgetsinstrumentation.h"
+
+WIDGETS_BEGIN_NAMESPACE
+
+Instrumentation *Instrumentation::instance()
+{
+    static Instrumentation *gInstance = nullptr;
+    if (!gInstance)
+        gInstance = new Instrumentation();
+    return gInstance;
+}
+
+Instrumentation::Instrumentation(QObject *parent)
+    : QObject(parent)
+{
+}
+
+bool Instrumentation::isEnabled() const
+{
+    return m_enabled;
+}
+
+void Instrumentation::setEnabled(const bool enabled)
+{
+    if (m_enabled == enabled)
+        return;
+
+    m_enabled = enabled;
+    if (!m_enabled)
+        m_traces.clear();
+}
+
+void Instrumentation::beginFrameTrace(const QString &name)
+{
+    if (!m_enabled)
+        return;
+
+    if (m_traces[name]++ == 0)
+        Q_EMIT frameTraceBegan(name);
+}
+
+void Instrumentation::endFrameTrace(const QString &name)
+{
+    if (!m_enabled)
+        return;
+
+    auto iter = m_traces.find(name);
+    if (iter == m_traces.end())
+        return;
+
+    if (--iter.value() <= 0) {
+        m_traces.erase(iter);
+        Q_EMIT frameTraceEnded(name);
+    }
+}
+
+void Instrumentation::markFrame(const QString &name)
+{
+    if (!m_enabled || !m_traces.contains(name))
+        return;
+
+    Q_EMIT frameMarked(name);
+}
+
+void Instrumentation::setMetric(const QString &key, const QVariant &value)
+{
+    m_metrics[key] = value;
+    if (m_enabled)
+        Q_EMIT metricChanged(key, value);
+}
+
+QVariantMap Instrumentation::metrics() const
+{
+    return m_metrics;
+}
+
+FrameTraceScope::FrameTraceScope(const QString &name)
+    : m_name(name)
+{
+    Instrumentation::instance()->beginFrameTrace(m_name);
+}
+
+FrameTraceScope::~FrameTraceScope()
+{
+    Instrumentation::instance()->endFrameTrace(m_name);
+}
+
+WIDGETS_END_NAMESPACE
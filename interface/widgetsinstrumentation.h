@@ -0,0 +1,94 @@
+/*
+ * Copyright (C) 2022 UnionTech Technology Co., Ltd.
+ *
+ * Author:     yeshanshan <yeshanshan@uniontech.com>
+ *
+ * Maintainer: yeshanshan <yeshanshan@uniontech.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <widgetsglobal.h>
+#include <QObject>
+#include <QHash>
+#include <QVariant>
+
+WIDGETS_BEGIN_NAMESPACE
+/**
+ * @brief 性能埋点，插件和框架通过它标记需要记录帧时间的区间以及上报指标，
+ * 未开启记录时调用开销仅为一次判断。
+ */
+class Q_DECL_EXPORT Instrumentation : public QObject
+{
+    Q_OBJECT
+public:
+    static Instrumentation *instance();
+
+    /**
+     * @brief 是否有记录者在监听，关闭时埋点调用直接返回
+     */
+    bool isEnabled() const;
+    void setEnabled(const bool enabled);
+
+    /**
+     * @brief 开始一个帧时间记录区间，同名区间可嵌套，计数归零时才结束
+     */
+    void beginFrameTrace(const QString &name);
+
+    /**
+     * @brief 结束一个帧时间记录区间
+     */
+    void endFrameTrace(const QString &name);
+
+    /**
+     * @brief 为区间主动标记一帧，用于只移动窗口、不产生重绘的动画，
+     * 标记过的区间不再按窗口重绘计帧
+     */
+    void markFrame(const QString &name);
+
+    /**
+     * @brief 上报一个指标值，始终保存最新值
+     */
+    void setMetric(const QString &key, const QVariant &value);
+    QVariantMap metrics() const;
+
+Q_SIGNALS:
+    void frameTraceBegan(const QString &name);
+    void frameTraceEnded(const QString &name);
+    void frameMarked(const QString &name);
+    void metricChanged(const QString &key, const QVariant &value);
+
+private:
+    explicit Instrumentation(QObject *parent = nullptr);
+
+    bool m_enabled = false;
+    QHash<QString, int> m_traces;
+    QVariantMap m_metrics;
+};
+
+/**
+ * @brief 以作用域为界的帧时间记录区间
+ */
+class Q_DECL_EXPORT FrameTraceScope
+{
+public:
+    explicit FrameTraceScope(const QString &name);
+    ~FrameTraceScope();
+
+private:
+    QString m_name;
+};
+WIDGETS_END_NAMESPACE
@@ -58,4 +58,8 @@ QString IWidget::userInterfaceLanguage()
     return qApp->property("dapp_locale").toString();
 }
 
+IWidgetExtension::~IWidgetExtension()
+{
+}
+
 WIDGETS_END_NAMESPACE
@@ -22,14 +22,18 @@
 #pragma once
 
 #include <widgetsglobal.h>
+#include <widgetspixmapcache.h>
 #include <QStringList>
 #include <QVariant>
 #include <QSize>
 #include <QIcon>
 #include <QLoggingCategory>
 
+#include <functional>
+
 QT_BEGIN_NAMESPACE
 class QWidget;
+class QObject;
 QT_END_NAMESPACE
 
 WIDGETS_BEGIN_NAMESPACE
@@ -96,6 +100,16 @@ public:
      */
     virtual void hideWidgets() {}
 
+    /**
+     * @brief 组件内容的可见状态
+     */
+    enum VisibilityState {
+        Hidden,      // 面板收起，或所在区域没有显示
+        Visible,     // 显示在屏幕上
+        ScrolledOff, // 面板展开，但滚动到了可视区域之外
+        Editing      // 显示在编辑模式下
+    };
+
     /**
      * @brief 组件移除时被调用
      */
@@ -121,6 +135,34 @@ private:
     friend class WidgetPluginSpec;
 };
 
+/**
+ * @brief 组件的可选扩展接口，组件类同时继承IWidget和它来接收新增的回调，
+ * 框架通过dynamic_cast判断组件是否实现，IWidget的虚表布局保持不变
+ */
+class Q_DECL_EXPORT IWidgetExtension
+{
+public:
+    IWidgetExtension() = default;
+    virtual ~IWidgetExtension();
+
+    /**
+     * @brief 可见状态变化时被调用，isPreview 为组件商店中的预览实例，
+     * 不可见时可以停止采样、动画及网络请求
+     */
+    virtual void visibilityChanged(const IWidget::VisibilityState /*state*/, const bool /*isPreview*/) { }
+
+    /**
+     * @brief 面板长时间收起后被调用，组件将状态保存到handler()的存储中并释放view()，
+     * 返回false表示不支持休眠；休眠期间框架显示组件的截图
+     */
+    virtual bool hibernate() { return false; }
+
+    /**
+     * @brief 从休眠中恢复，组件重新创建view()并恢复状态，之后框架会调用typeChanged
+     */
+    virtual void wakeup() {}
+};
+
 /**
  * @brief 组件处理器，提供每个组件实例能够访问的接口
  */
@@ -174,6 +216,42 @@ public:
      * @brief 组件应该设置的大小
      */
     virtual QSize size() const = 0;
+
+    /**
+     * @brief 常用的定时回调周期，单位毫秒
+     */
+    enum TickInterval {
+        PerSecond = 1000,
+        PerMinute = 60 * 1000
+    };
+
+    /**
+     * @brief 订阅与系统时钟对齐的定时回调，所有组件的回调合并唤醒，面板不可见时暂停，
+     * 恢复时立即回调一次；context销毁后自动取消，返回订阅Id，失败时返回-1
+     */
+    virtual int subscribeTick(const int /*interval*/, QObject */*context*/, const std::function<void()> &/*callback*/) { return -1; }
+
+    /**
+     * @brief 取消定时回调
+     */
+    virtual void unsubscribeTick(const int /*tickId*/) { }
+
+    /**
+     * @brief 在宿主管理的线程池中执行任务，结果在主线程中通过finished返回，
+     * context销毁或任务取消后不再回调，组件移除时自动取消，返回任务Id，失败时返回-1
+     */
+    virtual int submitTask(QObject */*context*/, const std::function<QVariant()> &/*task*/,
+                           const std::function<void(const QVariant &)> &/*finished*/) { return -1; }
+
+    /**
+     * @brief 取消任务，未开始的任务不再执行，执行中的任务结果被丢弃
+     */
+    virtual void cancelTask(const int /*taskId*/) { }
+
+    /**
+     * @brief 进程内共享的图片缓存，组件加载主题图标、DCI图标时优先通过它获取
+     */
+    virtual PixmapCache *pixmapCache() const { return PixmapCache::instance(); }
 };
 
 /**
@@ -0,0 +1,158 @@
+/*
+ * Copyright (C) 2022 UnionTech Technology Co., Ltd.
+ *
+ * Author:     yeshanshan <yeshanshan@uniontech.com>
+ *
+ * Maintainer: yeshanshan <yeshanshan@uniontech.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "widgetspixmapcache.h"
+#include "widgetsinstrumentation.h"
+
+#include <QGuiApplication>
+#include <QIcon>
+#include <QScreen>
+
+#include <limits>
+
+WIDGETS_BEGIN_NAMESPACE
+
+// QCache的cost为int，以KB计数
+static const int DefaultMemoryBudget = 16 * 1024;
+
+static int pixmapCost(const QPixmap &pixmap)
+{
+    const qint64 bytes = qint64(pixmap.width()) * pixmap.height() * pixmap.depth() / 8;
+    return qMax<int>(1, int((bytes + 1023) / 1024));
+}
+
+PixmapCache *PixmapCache::instance()
+{
+    static PixmapCache *gInstance = nullptr;
+    if (!gInstance)
+        gInstance = new PixmapCache();
+    return gInstance;
+}
+
+PixmapCache::PixmapCache(QObject *parent)
+    : QObject(parent)
+    , m_cache(DefaultMemoryBudget)
+{
+    if (!qGuiApp)
+        return;
+
+    for (auto screen : qGuiApp->screens())
+        watchScreen(screen);
+    connect(qGuiApp, &QGuiApplication::screenAdded, this, &PixmapCache::watchScreen);
+}
+
+void PixmapCache::watchScreen(QScreen *screen)
+{
+    // 缩放比变化后旧尺寸的图片不会再被命中，直接释放
+    connect(screen, &QScreen::logicalDotsPerInchChanged, this, &PixmapCache::clear);
+    connect(screen, &QScreen::physicalDotsPerInchChanged, this, &PixmapCache::clear);
+}
+
+QString PixmapCache::key(const QString &name, const QSize &size, const qreal dpr, const QString &variant)
+{
+    return QString("%1|%2x%3|%4|%5").arg(name).arg(size.width()).arg(size.height()).arg(dpr).arg(variant);
+}
+
+QPixmap PixmapCache::pixmap(const QString &key, const Loader &loader)
+{
+    // 命中时只计数，在插入或清空时随其他统计一起上报
+    if (auto cached = m_cache.object(key)) {
+        ++m_hits;
+        return *cached;
+    }
+
+    ++m_misses;
+    const QPixmap &pixmap = loader ? loader() : QPixmap();
+    insert(key, pixmap);
+    return pixmap;
+}
+
+QPixmap PixmapCache::themeIcon(const QString &name, const QSize &size, qreal dpr)
+{
+    if (qFuzzyIsNull(dpr))
+        dpr = qGuiApp ? qGuiApp->devicePixelRatio() : 1.0;
+
+    return pixmap(key(name, size, dpr, QIcon::themeName()), [name, size, dpr]() {
+        const QSize deviceSize = size * dpr;
+        QPixmap pixmap = QIcon::fromTheme(name).pixmap(deviceSize);
+        if (pixmap.isNull())
+            return pixmap;
+
+        if (pixmap.size() != deviceSize)
+            pixmap = pixmap.scaled(deviceSize, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+        pixmap.setDevicePixelRatio(dpr);
+        return pixmap;
+    });
+}
+
+bool PixmapCache::contains(const QString &key) const
+{
+    return m_cache.contains(key);
+}
+
+void PixmapCache::insert(const QString &key, const QPixmap &pixmap)
+{
+    // 空图片也缓存，避免反复查找不存在的图标
+    m_cache.insert(key, new QPixmap(pixmap), pixmapCost(pixmap));
+    reportStats();
+}
+
+qint64 PixmapCache::memoryBudget() const
+{
+    return qint64(m_cache.maxCost()) * 1024;
+}
+
+void PixmapCache::setMemoryBudget(const qint64 bytes)
+{
+    m_cache.setMaxCost(int(qBound<qint64>(0, bytes / 1024, std::numeric_limits<int>::max())));
+    reportStats();
+}
+
+qint64 PixmapCache::memoryUsage() const
+{
+    return qint64(m_cache.totalCost()) * 1024;
+}
+
+int PixmapCache::count() const
+{
+    return m_cache.count();
+}
+
+void PixmapCache::clear()
+{
+    if (m_cache.isEmpty())
+        return;
+
+    m_cache.clear();
+    reportStats();
+    Q_EMIT cleared();
+}
+
+void PixmapCache::reportStats() const
+{
+    auto instrumentation = Instrumentation::instance();
+    instrumentation->setMetric("pixmapCache.bytes", memoryUsage());
+    instrumentation->setMetric("pixmapCache.count", count());
+    instrumentation->setMetric("pixmapCache.hits", m_hits);
+    instrumentation->setMetric("pixmapCache.misses", m_misses);
+}
+
+WIDGETS_END_NAMESPACE
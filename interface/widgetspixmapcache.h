@@ -0,0 +1,84 @@
+/*
+ * Copyright (C) 2022 UnionTech Technology Co., Ltd.
+ *
+ * Author:     yeshanshan <yeshanshan@uniontech.com>
+ *
+ * Maintainer: yeshanshan <yeshanshan@uniontech.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <widgetsglobal.h>
+#include <QObject>
+#include <QCache>
+#include <QPixmap>
+
+#include <functional>
+
+QT_BEGIN_NAMESPACE
+class QScreen;
+QT_END_NAMESPACE
+
+WIDGETS_BEGIN_NAMESPACE
+/**
+ * @brief 进程内共享的图片缓存，按(名称, 尺寸, 缩放比, 主题变体)索引，
+ * 超出内存预算时淘汰最久未使用的图片，主题或缩放比变化时清空。
+ */
+class Q_DECL_EXPORT PixmapCache : public QObject
+{
+    Q_OBJECT
+public:
+    using Loader = std::function<QPixmap()>;
+
+    static PixmapCache *instance();
+
+    static QString key(const QString &name, const QSize &size, const qreal dpr, const QString &variant = QString());
+
+    /**
+     * @brief 查找缓存，未命中时调用loader生成并缓存，同一个key只解码缩放一次
+     */
+    QPixmap pixmap(const QString &key, const Loader &loader);
+
+    /**
+     * @brief 主题图标，size为逻辑尺寸，dpr为0时使用应用的缩放比
+     */
+    QPixmap themeIcon(const QString &name, const QSize &size, qreal dpr = 0);
+
+    bool contains(const QString &key) const;
+    void insert(const QString &key, const QPixmap &pixmap);
+
+    // 单位为字节
+    qint64 memoryBudget() const;
+    void setMemoryBudget(const qint64 bytes);
+    qint64 memoryUsage() const;
+    int count() const;
+
+public Q_SLOTS:
+    void clear();
+
+Q_SIGNALS:
+    void cleared();
+
+private:
+    explicit PixmapCache(QObject *parent = nullptr);
+    void watchScreen(QScreen *screen);
+    void reportStats() const;
+
+    QCache<QString, QPixmap> m_cache;
+    qint64 m_hits = 0;
+    qint64 m_misses = 0;
+};
+WIDGETS_END_NAMESPACE
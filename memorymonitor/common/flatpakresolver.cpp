@@ -0,0 +1,184 @@
+/*
+ * Copyright (C) 2022 UnionTech Technology Co., Ltd.
+ *
+ * Author:     yeshanshan <yeshanshan@uniontech.com>
+ *
+ * Maintainer: yeshanshan <yeshanshan@uniontech.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "flatpakresolver.h"
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QFileSystemWatcher>
+#include <QMutexLocker>
+
+namespace Utils {
+
+// 读取 ini 格式文件中指定分组的若干字段，不需要 QSettings 的列表转义
+static QHash<QByteArray, QString> readGroup(const QString &fileName, const QByteArray &group,
+                                            const QList<QByteArray> &keys)
+{
+    QHash<QByteArray, QString> values;
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
+        return values;
+
+    const QByteArray header = '[' + group + ']';
+    bool inGroup = false;
+    while (!file.atEnd()) {
+        const QByteArray line = file.readLine().trimmed();
+        if (line.startsWith('[')) {
+            if (inGroup)
+                break;
+            inGroup = line == header;
+            continue;
+        }
+        if (!inGroup)
+            continue;
+
+        const int index = line.indexOf('=');
+        if (index <= 0)
+            continue;
+        const QByteArray key = line.left(index).trimmed();
+        if (keys.contains(key) && !values.contains(key))
+            values.insert(key, QString::fromUtf8(line.mid(index + 1).trimmed()));
+    }
+    return values;
+}
+
+FlatpakResolver *FlatpakResolver::instance()
+{
+    static FlatpakResolver *gInstance = nullptr;
+    if (!gInstance)
+        gInstance = new FlatpakResolver();
+    return gInstance;
+}
+
+FlatpakResolver::FlatpakResolver(QObject *parent)
+    : QObject(parent)
+{
+    // 与 flatpak 的默认安装位置一致，可以通过环境变量覆盖
+    QString userDir = qEnvironmentVariable("FLATPAK_USER_DIR");
+    if (userDir.isEmpty())
+        userDir = QDir::homePath() + "/.local/share/flatpak";
+    QString systemDir = qEnvironmentVariable("FLATPAK_SYSTEM_DIR");
+    if (systemDir.isEmpty())
+        systemDir = "/var/lib/flatpak";
+    m_installations << userDir << systemDir;
+
+    watchInstallations();
+}
+
+FlatpakAppInfo FlatpakResolver::lookup(const QString &appId)
+{
+    const QString id = normalizeAppId(appId);
+    quint64 generation = 0;
+    {
+        QMutexLocker locker(&m_mutex);
+        auto iter = m_cache.constFind(id);
+        if (iter != m_cache.constEnd())
+            return iter.value();
+        generation = m_generation;
+    }
+
+    const FlatpakAppInfo info = parse(id);
+    QMutexLocker locker(&m_mutex);
+    if (generation == m_generation)
+        m_cache.insert(id, info);
+    return info;
+}
+
+QString FlatpakResolver::normalizeAppId(const QString &appIdOrRef)
+{
+    QString id = appIdOrRef.trimmed();
+    if (id.startsWith("app/"))
+        id = id.mid(4);
+    return id.section('/', 0, 0);
+}
+
+FlatpakAppInfo FlatpakResolver::parse(const QString &appId) const
+{
+    FlatpakAppInfo info;
+    info.appId = appId;
+    if (appId.isEmpty())
+        return info;
+
+    for (const auto &installation : m_installations) {
+        // current/active 指向当前部署的提交
+        const QFileInfo active(QString("%1/app/%2/current/active").arg(installation, appId));
+        if (!active.exists())
+            continue;
+
+        info.location = active.canonicalFilePath();
+        const auto &metadata = readGroup(info.location + "/metadata", "Application", {"name", "command"});
+        info.command = metadata.value("command");
+
+        const QString exportDir = info.location + "/export/share";
+        const auto &desktop = readGroup(QString("%1/applications/%2.desktop").arg(exportDir, appId),
+                                        "Desktop Entry", {"Name", "Icon"});
+        info.name = desktop.value("Name", metadata.value("name", appId));
+
+        // 优先使用矢量图标，其次使用最大的位图
+        const QString iconName = desktop.value("Icon", appId);
+        static const QStringList iconDirs = {"scalable", "512x512", "256x256", "128x128", "96x96", "64x64", "48x48"};
+        for (const auto &dir : iconDirs) {
+            for (const auto &suffix : {".svg", ".png"}) {
+                const QString fileName = QString("%1/icons/hicolor/%2/apps/%3").arg(exportDir, dir, iconName) + suffix;
+                if (QFileInfo::exists(fileName)) {
+                    info.icon = fileName;
+                    break;
+                }
+            }
+            if (!info.icon.isEmpty())
+                break;
+        }
+        break;
+    }
+    return info;
+}
+
+void FlatpakResolver::watchInstallations()
+{
+    // flatpak 每次安装、更新、卸载后都会修改安装目录下的 .changed 文件
+    m_watcher = new QFileSystemWatcher(this);
+    for (const auto &installation : m_installations) {
+        if (QFileInfo::exists(installation + "/.changed"))
+            m_watcher->addPath(installation + "/.changed");
+        if (QFileInfo::exists(installation + "/app"))
+            m_watcher->addPath(installation + "/app");
+        else if (QFileInfo::exists(installation))
+            m_watcher->addPath(installation);
+    }
+    connect(m_watcher, &QFileSystemWatcher::fileChanged, this, &FlatpakResolver::invalidate);
+    connect(m_watcher, &QFileSystemWatcher::directoryChanged, this, &FlatpakResolver::invalidate);
+}
+
+void FlatpakResolver::invalidate()
+{
+    {
+        QMutexLocker locker(&m_mutex);
+        m_cache.clear();
+        ++m_generation;
+    }
+
+    // 文件被替换后监听会失效，重新添加
+    delete m_watcher;
+    watchInstallations();
+}
+
+}  // namespace Utils
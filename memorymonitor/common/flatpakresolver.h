@@ -0,0 +1,77 @@
+/*
+ * Copyright (C) 2022 UnionTech Technology Co., Ltd.
+ *
+ * Author:     yeshanshan <yeshanshan@uniontech.com>
+ *
+ * Maintainer: yeshanshan <yeshanshan@uniontech.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <QObject>
+#include <QHash>
+#include <QMutex>
+#include <QStringList>
+
+class QFileSystemWatcher;
+
+namespace Utils {
+
+// flatpak 应用在磁盘上的部署信息
+struct FlatpakAppInfo {
+    QString appId;
+    // 当前部署的目录，包含 files、export 和 metadata
+    QString location;
+    QString name;
+    QString command;
+    // 导出的图标文件路径，没有时为空
+    QString icon;
+
+    bool isValid() const { return !location.isEmpty(); }
+};
+
+/**
+ * @brief 直接解析 flatpak 安装目录中的部署信息，不启动 flatpak 进程。
+ * 结果按应用Id缓存，安装目录变化时清空，lookup 可以在任意线程调用
+ */
+class FlatpakResolver : public QObject
+{
+    Q_OBJECT
+public:
+    // 需要在主线程中首次调用
+    static FlatpakResolver *instance();
+
+    // 同步解析，只读取几个小文件，不要在主线程中批量调用
+    FlatpakAppInfo lookup(const QString &appId);
+
+    // 兼容 "app/<id>/<arch>/<branch>" 形式的引用
+    static QString normalizeAppId(const QString &appIdOrRef);
+
+private:
+    explicit FlatpakResolver(QObject *parent = nullptr);
+    FlatpakAppInfo parse(const QString &appId) const;
+    void watchInstallations();
+    void invalidate();
+
+    QStringList m_installations;
+    QFileSystemWatcher *m_watcher = nullptr;
+    mutable QMutex m_mutex;
+    QHash<QString, FlatpakAppInfo> m_cache;
+    // 缓存清空后，清空前开始的解析结果不再写入
+    quint64 m_generation = 0;
+};
+
+}  // namespace Utils
@@ -190,53 +190,6 @@ QString getQrcPath(QString imageName)
     return QString(":/image/%1").arg(imageName);
 }
 
-QDir getFlatpakAppPath(const QString &flatpakAppid)
-{
-    QProcess whichProcess;
-    QString exec = "flatpak";
-    QStringList params;
-    params << "info";
-    params << flatpakAppid;
-    whichProcess.start(exec, params);
-    whichProcess.waitForFinished();
-    QString output(whichProcess.readAllStandardOutput());
-
-    return QDir(output.split("Location:")[1].split("\n")[0].simplified());
-}
-
-QString getFlatpakAppIcon(const QString &flatpakAppid)
-{
-    QString exec = "flatpak";
-
-    QStringList params;
-    params << "info";
-    params << flatpakAppid;
-
-    // set the LANGUAGE env so that the output is fixed to be English,
-    // or below code may break in other locales like pt_BR.
-    QProcessEnvironment env = QProcessEnvironment::systemEnvironment();
-    env.insert("LANGUAGE", "en_US");
-
-    QProcess whichProcess;
-    whichProcess.setProcessEnvironment(env);
-    whichProcess.start(exec, params);
-    whichProcess.waitForFinished();
-    QString output(whichProcess.readAllStandardOutput());
-
-    const QString dirPath = output.split("Location:")[1].split("\n")[0].simplified();
-
-    QDir flatpakDir = QDir(dirPath);
-    flatpakDir.cd("export");
-    flatpakDir.cd("share");
-    flatpakDir.cd("icons");
-    flatpakDir.cd("hicolor");
-    flatpakDir.cd("scalable");
-    flatpakDir.cd("apps");
-
-    const QString appID = flatpakAppid.split("app/")[1].split("/")[0];
-    return flatpakDir.filePath(QString("%1.svg").arg(appID));
-}
-
 bool fileExists(const QString &path)
 {
     QFileInfo check_file(path);
@@ -105,8 +105,6 @@ QString getProcessCmdline(pid_t pid);
 QString getProcessEnvironmentVariable(pid_t pid, const QString &environmentName);
 QString getProcessNameFromCmdLine(const pid_t pid);
 QString getQrcPath(QString imageName);
-QString getFlatpakAppIcon(const QString &flatpakAppid);
-QDir getFlatpakAppPath(const QString &flatpakAppid);
 bool fileExists(const QString &path);
 void drawLoadingRing(QPainter &painter, int centerX, int centerY, int radius, int penWidth,
                      int loadingAngle, int rotationAngle, QColor foregroundColor,
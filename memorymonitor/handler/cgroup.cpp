@@ -0,0 +1,258 @@
+/*
+ * Copyright (C) 2022 UnionTech Technology Co., Ltd.
+ *
+ * Author:     yeshanshan <yeshanshan@uniontech.com>
+ *
+ * Maintainer: yeshanshan <yeshanshan@uniontech.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "cgroup.h"
+
+#include <QDebug>
+#include <QFile>
+#include <QFileInfo>
+
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+
+namespace core {
+namespace system {
+
+static const char *const CgroupFileNames[] = {
+    "memory.current",
+    "memory.max",
+    "memory.high",
+    "memory.stat",
+    "memory.events",
+    "memory.pressure"
+};
+
+// 读取整个小文件到栈上的缓冲区，返回读取的长度
+template<int N>
+static int readFile(const int fd, char (&buffer)[N])
+{
+    if (fd < 0)
+        return -1;
+    const ssize_t size = pread(fd, buffer, N, 0);
+    return int(size);
+}
+
+// 逐行解析 "key value"，fieldOf 返回需要的字段，其余忽略
+template<typename FieldOf>
+static bool parseKeyValues(const char *data, const int size, FieldOf fieldOf)
+{
+    const char *p = data;
+    const char *end = data + size;
+    bool matched = false;
+    while (p < end) {
+        const char *key = p;
+        while (p < end && *p != ' ' && *p != '\n')
+            ++p;
+        if (p >= end)
+            break;
+
+        qulonglong *field = *p == ' ' ? fieldOf(key, int(p - key)) : nullptr;
+        if (field) {
+            ++p;
+            qulonglong value = 0;
+            const char *digits = p;
+            while (p < end && *p >= '0' && *p <= '9')
+                value = value * 10 + qulonglong(*p++ - '0');
+            if (p > digits && p < end) {
+                *field = value;
+                matched = true;
+            }
+        }
+
+        while (p < end && *p != '\n')
+            ++p;
+        ++p;
+    }
+    return matched;
+}
+
+#define MATCH_FIELD(target, name, field) \
+    if (length == int(sizeof(name) - 1) && !memcmp(key, name, sizeof(name) - 1)) return &target.field;
+
+bool CgroupSampler::parseStat(const char *data, const int size, CgroupMemInfo &info)
+{
+    // memory.stat 的单位为字节，解析后换算为KB
+    CgroupMemInfo bytes;
+    const bool matched = parseKeyValues(data, size, [&bytes](const char *key, const int length) -> qulonglong * {
+        MATCH_FIELD(bytes, "anon", anon);
+        MATCH_FIELD(bytes, "file", file);
+        MATCH_FIELD(bytes, "kernel", kernel);
+        MATCH_FIELD(bytes, "shmem", shmem);
+        MATCH_FIELD(bytes, "sock", sock);
+        return nullptr;
+    });
+    if (!matched)
+        return false;
+
+    info.anon = bytes.anon >> 10;
+    info.file = bytes.file >> 10;
+    info.kernel = bytes.kernel >> 10;
+    info.shmem = bytes.shmem >> 10;
+    info.sock = bytes.sock >> 10;
+    return true;
+}
+
+bool CgroupSampler::parseEvents(const char *data, const int size, CgroupMemInfo &info)
+{
+    return parseKeyValues(data, size, [&info](const char *key, const int length) -> qulonglong * {
+        MATCH_FIELD(info, "high", highEvents);
+        MATCH_FIELD(info, "max", maxEvents);
+        MATCH_FIELD(info, "oom", oomEvents);
+        MATCH_FIELD(info, "oom_kill", oomKillEvents);
+        return nullptr;
+    });
+}
+
+#undef MATCH_FIELD
+
+bool CgroupSampler::parseLimit(const char *data, const int size, qulonglong &value)
+{
+    // 未限制时内容为 "max"
+    if (size >= 3 && !memcmp(data, "max", 3)) {
+        value = 0;
+        return true;
+    }
+
+    qulonglong bytes = 0;
+    int i = 0;
+    for (; i < size && data[i] >= '0' && data[i] <= '9'; ++i)
+        bytes = bytes * 10 + qulonglong(data[i] - '0');
+    if (i == 0)
+        return false;
+
+    value = bytes >> 10;
+    return true;
+}
+
+CgroupSampler::CgroupSampler(const QString &path)
+    : m_path(path.isEmpty() ? userCgroupPath() : path)
+{
+    for (auto &fd : m_fds)
+        fd = -1;
+
+    if (m_path.isEmpty())
+        return;
+
+    for (int i = 0; i < FileCount; ++i) {
+        const QByteArray fileName = QFile::encodeName(m_path + "/" + CgroupFileNames[i]);
+        m_fds[i] = open(fileName.constData(), O_RDONLY | O_CLOEXEC);
+    }
+    if (m_fds[Current] < 0)
+        qDebug() << "cgroup memory controller is unavailable in" << m_path;
+}
+
+CgroupSampler::~CgroupSampler()
+{
+    for (const auto fd : m_fds) {
+        if (fd >= 0)
+            close(fd);
+    }
+}
+
+bool CgroupSampler::isValid() const
+{
+    return m_fds[Current] >= 0;
+}
+
+QString CgroupSampler::path() const
+{
+    return m_path;
+}
+
+bool CgroupSampler::sample(CgroupMemInfo &info)
+{
+    char buffer[2048];
+    int size = readFile(m_fds[Current], buffer);
+    qulonglong current = 0;
+    if (size <= 0 || !parseLimit(buffer, size, current))
+        return false;
+    info.current = current;
+
+    // 其它文件缺失时保留默认值，上限文件在根 cgroup 中不存在
+    if ((size = readFile(m_fds[Max], buffer)) > 0)
+        parseLimit(buffer, size, info.max);
+    if ((size = readFile(m_fds[High], buffer)) > 0)
+        parseLimit(buffer, size, info.high);
+    if ((size = readFile(m_fds[Stat], buffer)) > 0)
+        parseStat(buffer, size, info);
+    if ((size = readFile(m_fds[Events], buffer)) > 0)
+        parseEvents(buffer, size, info);
+    if ((size = readFile(m_fds[Pressure], buffer)) > 0)
+        PressureSampler::parse(buffer, size, info.pressure);
+    return true;
+}
+
+QString CgroupSampler::mountPoint()
+{
+    // 纯 v2 挂载在 /sys/fs/cgroup，混合模式通常挂载在 /sys/fs/cgroup/unified
+    QFile mountInfo("/proc/self/mountinfo");
+    if (!mountInfo.open(QIODevice::ReadOnly | QIODevice::Text))
+        return QString();
+
+    while (!mountInfo.atEnd()) {
+        const QByteArray line = mountInfo.readLine();
+        // 可选字段之后以 " - " 分隔文件系统类型
+        const int separator = line.indexOf(" - ");
+        if (separator < 0 || !line.mid(separator + 3).startsWith("cgroup2 "))
+            continue;
+
+        const QList<QByteArray> fields = line.left(separator).split(' ');
+        if (fields.size() > 4)
+            return QString::fromUtf8(fields.at(4));
+    }
+    return QString();
+}
+
+QString CgroupSampler::userCgroupPath()
+{
+    const QString mount = mountPoint();
+    if (mount.isEmpty())
+        return QString();
+
+    QFile cgroup("/proc/self/cgroup");
+    if (!cgroup.open(QIODevice::ReadOnly | QIODevice::Text))
+        return QString();
+
+    // v2 层级的条目为 "0::<path>"
+    QString selfPath;
+    while (!cgroup.atEnd()) {
+        const QByteArray line = cgroup.readLine().trimmed();
+        if (line.startsWith("0::")) {
+            selfPath = QString::fromUtf8(line.mid(3));
+            break;
+        }
+    }
+    if (selfPath.isEmpty())
+        return QString();
+
+    // 取路径中当前用户的 user-<uid>.slice，不在用户会话中时使用自身所在的 cgroup
+    const QString userSlice = QString("user-%1.slice").arg(getuid());
+    const int index = selfPath.indexOf("/" + userSlice);
+    if (index >= 0)
+        selfPath = selfPath.left(index + userSlice.length() + 1);
+
+    const QString path = QFileInfo(mount + selfPath).absoluteFilePath();
+    return QFileInfo::exists(path + "/memory.current") ? path : QString();
+}
+
+} // namespace system
+} // namespace core
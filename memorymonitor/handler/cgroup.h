@@ -0,0 +1,97 @@
+/*
+ * Copyright (C) 2022 UnionTech Technology Co., Ltd.
+ *
+ * Author:     yeshanshan <yeshanshan@uniontech.com>
+ *
+ * Maintainer: yeshanshan <yeshanshan@uniontech.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "pressure.h"
+
+#include <QString>
+
+namespace core {
+namespace system {
+
+// cgroup v2 内存控制器的数据，单位为KB
+struct CgroupMemInfo {
+    qulonglong current = 0;     // memory.current
+    qulonglong max = 0;         // memory.max，0表示不限制
+    qulonglong high = 0;        // memory.high，0表示不限制
+
+    // memory.stat
+    qulonglong anon = 0;
+    qulonglong file = 0;
+    qulonglong kernel = 0;
+    qulonglong shmem = 0;
+    qulonglong sock = 0;
+
+    // memory.events，累计次数
+    qulonglong highEvents = 0;  // 超过 memory.high 被限流
+    qulonglong maxEvents = 0;   // 达到 memory.max 触发回收
+    qulonglong oomEvents = 0;
+    qulonglong oomKillEvents = 0;
+
+    // memory.pressure
+    PressureInfo pressure;
+
+    // 有效的上限，优先使用 memory.max，未设置时返回0
+    qulonglong limit() const { return max > 0 ? max : high; }
+};
+
+/**
+ * @brief 读取当前用户会话所在的 cgroup v2 的内存数据，
+ * 路径只在创建时解析一次，文件保持打开，采样时就地解析，不分配内存
+ */
+class CgroupSampler
+{
+public:
+    // path为空时使用当前用户的 user-<uid>.slice
+    explicit CgroupSampler(const QString &path = QString());
+    ~CgroupSampler();
+    CgroupSampler(const CgroupSampler &) = delete;
+    CgroupSampler &operator=(const CgroupSampler &) = delete;
+
+    bool isValid() const;
+    QString path() const;
+    bool sample(CgroupMemInfo &info);
+
+    static QString mountPoint();
+    static QString userCgroupPath();
+
+    static bool parseStat(const char *data, const int size, CgroupMemInfo &info);
+    static bool parseEvents(const char *data, const int size, CgroupMemInfo &info);
+    static bool parseLimit(const char *data, const int size, qulonglong &value);
+
+private:
+    enum File {
+        Current = 0,
+        Max,
+        High,
+        Stat,
+        Events,
+        Pressure,
+        FileCount
+    };
+
+    QString m_path;
+    int m_fds[FileCount];
+};
+
+} // namespace system
+} // namespace core
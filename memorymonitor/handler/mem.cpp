@@ -18,227 +18,130 @@
 * along with this program.  If not, see <http://www.gnu.org/licenses/>.
 */
 #include "mem.h"
-#include "mem_p.h"
-
-#include <stdio.h>
-
-#include <memory>
 
 #include <QDebug>
-#include <unistd.h>
-#include <dirent.h>
-#include <errno.h>
-#include <stdio.h>
-#include <sys/time.h>
-
-#define PROC_PATH_MEM "/proc/meminfo"
 
-inline void print_errno(decltype(errno) e, const QString &msg)
-{
-    qWarning() << QString("Error: [%1] %2, ").arg(e).arg(strerror(e)) << msg;
-}
-
-struct uFileClose {
-    void operator()(FILE *fp)
-    {
-        fclose(fp);
-    }
-};
-using uFile = std::unique_ptr<FILE, uFileClose>;
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
 
 namespace core {
 namespace system {
 
-MemInfo::MemInfo()
-    : d(new MemInfoPrivate())
-{
-}
-MemInfo::MemInfo(const MemInfo &other)
-    : d(other.d)
-{
-}
-MemInfo &MemInfo::operator=(const MemInfo &rhs)
-{
-    if (this == &rhs)
-        return *this;
-
-    d = rhs.d;
-    return *this;
-}
-MemInfo::~MemInfo()
-{
-}
-
-qulonglong MemInfo::memTotal() const
-{
-    return d->mem_total_kb;
-}
-
-qulonglong MemInfo::memAvailable() const
-{
-    return d->mem_avail_kb;
-}
-
-qulonglong MemInfo::buffers() const
-{
-    return d->buffers_kb;
-}
-
-qulonglong MemInfo::cached() const
-{
-    return d->cached_kb;
-}
-
-qulonglong MemInfo::active() const
-{
-    return d->active_kb;
-}
-
-qulonglong MemInfo::inactive() const
-{
-    return d->inactive_kb;
-}
-
-qulonglong MemInfo::swapTotal() const
-{
-    return d->swap_total_kb;
+// 按字段名长度分派，再比较字段名，不需要的字段返回nullptr
+static qulonglong *fieldOf(MemInfo &info, const char *key, const int length)
+{
+#define MATCH_FIELD(name, field) \
+    if (!memcmp(key, name, sizeof(name) - 1)) return &info.field;
+
+    switch (length) {
+    case 4:
+        MATCH_FIELD("Slab", slab);
+        break;
+    case 5:
+        MATCH_FIELD("Shmem", shmem);
+        MATCH_FIELD("Dirty", dirty);
+        MATCH_FIELD("Zswap", zswap);
+        break;
+    case 6:
+        MATCH_FIELD("Cached", cached);
+        MATCH_FIELD("Active", active);
+        MATCH_FIELD("Mapped", mapped);
+        break;
+    case 7:
+        MATCH_FIELD("MemFree", memFree);
+        MATCH_FIELD("Buffers", buffers);
+        break;
+    case 8:
+        MATCH_FIELD("MemTotal", memTotal);
+        MATCH_FIELD("Inactive", inactive);
+        MATCH_FIELD("SwapFree", swapFree);
+        MATCH_FIELD("Zswapped", zswapped);
+        break;
+    case 9:
+        MATCH_FIELD("SwapTotal", swapTotal);
+        break;
+    case 10:
+        MATCH_FIELD("SwapCached", swapCached);
+        break;
+    case 12:
+        MATCH_FIELD("MemAvailable", memAvailable);
+        break;
+    default:
+        break;
+    }
+#undef MATCH_FIELD
+    return nullptr;
 }
 
-qulonglong MemInfo::swapFree() const
+MemInfoSampler::MemInfoSampler(const char *path)
 {
-    return d->swap_free_kb;
+    m_fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (m_fd < 0)
+        qWarning() << "open" << path << "failed:" << strerror(errno);
 }
 
-qulonglong MemInfo::swapCached() const
+MemInfoSampler::~MemInfoSampler()
 {
-    return d->swap_cached_kb;
+    if (m_fd >= 0)
+        close(m_fd);
 }
 
-qulonglong MemInfo::shmem() const
+bool MemInfoSampler::isValid() const
 {
-    return d->shmem_kb;
+    return m_fd >= 0;
 }
 
-qulonglong MemInfo::slab() const
+bool MemInfoSampler::sample(MemInfo &info)
 {
-    return d->slab_kb;
-}
+    if (m_fd < 0)
+        return false;
 
-qulonglong MemInfo::dirty() const
-{
-    return d->dirty_kb;
-}
+    // 当前内核的 /proc/meminfo 约1.5KB，需要的字段都在前部
+    char buffer[4096];
+    const ssize_t size = pread(m_fd, buffer, sizeof(buffer), 0);
+    if (size <= 0)
+        return false;
 
-qulonglong MemInfo::mapped() const
-{
-    return d->mapped_kb;
+    return parse(buffer, int(size), info);
 }
 
-void MemInfo::readMemInfo()
+bool MemInfoSampler::parse(const char *data, const int size, MemInfo &info)
 {
-    FILE *fp;
-
-    if ((fp = fopen(PROC_PATH_MEM, "r"))) {
-        uFile ufp(fp);
-        Q_UNUSED(ufp);
-
-        const size_t BUFLEN = 512;
-        QByteArray line(BUFLEN, '\0');
-        while (fgets(line.data(), BUFLEN, fp)) {
-            if (!strncmp(line.data(), "MemTotal:", 9)) {
-                int nr = sscanf(line.data() + 9, "%llu", &d->mem_total_kb);
-
-                if (nr != 1)
-                    print_errno(errno, QString("parse %1 -> %2 failed").arg(PROC_PATH_MEM).arg("MemTotal"));
-
-            } else if (!strncmp(line.data(), "MemFree:", 8)) {
-                int nr = sscanf(line.data() + 8, "%llu", &d->mem_free_kb);
-
-                if (nr != 1)
-                    print_errno(errno, QString("parse %1 -> %2 failed").arg(PROC_PATH_MEM).arg("MemFree"));
-
-            } else if (!strncmp(line.data(), "MemAvailable:", 13)) {
-                int nr = sscanf(line.data() + 13, "%llu", &d->mem_avail_kb);
-
-                if (nr != 1)
-                    print_errno(errno, QString("parse %1 -> %2 failed").arg(PROC_PATH_MEM).arg("MemAvailable"));
-
-            } else if (!strncmp(line.data(), "Buffers:", 8)) {
-                int nr = sscanf(line.data() + 8, "%llu", &d->buffers_kb);
-
-                if (nr != 1)
-                    print_errno(errno, QString("parse %1 -> %2 failed").arg(PROC_PATH_MEM).arg("Buffers"));
-
-            } else if (!strncmp(line.data(), "Cached:", 7)) {
-                int nr = sscanf(line.data() + 7, "%llu", &d->cached_kb);
-
-                if (nr != 1)
-                    print_errno(errno, QString("parse %1 -> %2 failed").arg(PROC_PATH_MEM).arg("Cached"));
+    const char *p = data;
+    const char *end = data + size;
+    bool hasTotal = false;
+    while (p < end) {
+        const char *key = p;
+        while (p < end && *p != ':' && *p != '\n')
+            ++p;
+        if (p >= end)
+            break;
 
-            } else if (!strncmp(line.data(), "SwapCached:", 11)) {
-                int nr = sscanf(line.data() + 11, "%llu", &d->swap_cached_kb);
+        qulonglong *field = *p == ':' ? fieldOf(info, key, int(p - key)) : nullptr;
+        if (field) {
+            ++p;
+            while (p < end && *p == ' ')
+                ++p;
 
-                if (nr != 1)
-                    print_errno(errno, QString("parse %1 -> %2 failed").arg(PROC_PATH_MEM).arg("SwapCached"));
+            qulonglong value = 0;
+            const char *digits = p;
+            while (p < end && *p >= '0' && *p <= '9')
+                value = value * 10 + qulonglong(*p++ - '0');
 
-            } else if (!strncmp(line.data(), "Active:", 7)) {
-                int nr = sscanf(line.data() + 7, "%llu", &d->active_kb);
-
-                if (nr != 1)
-                    print_errno(errno, QString("parse %1 -> %2 failed").arg(PROC_PATH_MEM).arg("Active"));
-
-            } else if (!strncmp(line.data(), "Inactive:", 9)) {
-                int nr = sscanf(line.data() + 9, "%llu", &d->inactive_kb);
-
-                if (nr != 1)
-                    print_errno(errno, QString("parse %1 -> %2 failed").arg(PROC_PATH_MEM).arg("Inactive"));
-
-            } else if (!strncmp(line.data(), "SwapTotal:", 10)) {
-                int nr = sscanf(line.data() + 10, "%llu", &d->swap_total_kb);
-
-                if (nr != 1)
-                    print_errno(errno, QString("parse %1 -> %2 failed").arg(PROC_PATH_MEM).arg("SwapTotal"));
-
-            } else if (!strncmp(line.data(), "SwapFree:", 9)) {
-                int nr = sscanf(line.data() + 9, "%llu", &d->swap_free_kb);
-
-                if (nr != 1)
-                    print_errno(errno, QString("parse %1 -> %2 failed").arg(PROC_PATH_MEM).arg("SwapFree"));
-
-            } else if (!strncmp(line.data(), "Dirty:", 6)) {
-                int nr = sscanf(line.data() + 6, "%llu", &d->dirty_kb);
-
-                if (nr != 1)
-                    print_errno(errno, QString("parse %1 -> %2 failed").arg(PROC_PATH_MEM).arg("Dirty"));
-
-            } else if (!strncmp(line.data(), "Shmem:", 6)) {
-                int nr = sscanf(line.data() + 6, "%llu", &d->shmem_kb);
-
-                if (nr != 1)
-                    print_errno(errno, QString("parse %1 -> %2 failed").arg(PROC_PATH_MEM).arg("Shmem"));
-
-            } else if (!strncmp(line.data(), "Slab:", 5)) {
-                int nr = sscanf(line.data() + 5, "%llu", &d->slab_kb);
-
-                if (nr != 1)
-                    print_errno(errno, QString("parse %1 -> %2 failed").arg(PROC_PATH_MEM).arg("Slab"));
-
-            } else if (!strncmp(line.data(), "Mapped:", 7)) {
-                int nr = sscanf(line.data() + 7, "%llu", &d->mapped_kb);
-
-                if (nr != 1)
-                    print_errno(errno, QString("parse %1 -> %2 failed").arg(PROC_PATH_MEM).arg("Mapped"));
+            // 缓冲区截断在数字中间时不更新该字段
+            if (p > digits && p < end) {
+                *field = value;
+                hasTotal = hasTotal || field == &info.memTotal;
             }
-        } // ::while(fgets)
-
-        if (ferror(fp)) {
-            print_errno(errno, QString("read %1 failed").arg(PROC_PATH_MEM));
         }
 
-        return;
-    } // ::if(fopen)
-
-    print_errno(errno, QString("open %1 failed").arg(PROC_PATH_MEM));
+        while (p < end && *p != '\n')
+            ++p;
+        ++p;
+    }
+    return hasTotal;
 }
 
 } // namespace system
@@ -20,39 +20,54 @@
 #ifndef MEM_H
 #define MEM_H
 
-#include <QSharedDataPointer>
+
+#include <QtGlobal>
 
 namespace core {
 namespace system {
 
-class MemInfoPrivate;
-class MemInfo
+// /proc/meminfo 中的字段，单位为KB，可重复使用
+struct MemInfo {
+    qulonglong memTotal = 0;     // MemTotal
+    qulonglong memFree = 0;      // MemFree
+    qulonglong memAvailable = 0; // MemAvailable
+    qulonglong buffers = 0;      // Buffers
+    qulonglong cached = 0;       // Cached
+    qulonglong active = 0;       // Active
+    qulonglong inactive = 0;     // Inactive
+
+    qulonglong swapTotal = 0;    // SwapTotal
+    qulonglong swapFree = 0;     // SwapFree
+    qulonglong swapCached = 0;   // SwapCached
+    qulonglong shmem = 0;        // Shmem
+    qulonglong slab = 0;         // Slab
+    qulonglong dirty = 0;        // Dirty
+    qulonglong mapped = 0;       // Mapped
+
+    qulonglong zswap = 0;        // Zswap，zswap 压缩池占用的内存
+    qulonglong zswapped = 0;     // Zswapped，压缩前的大小
+};
+
+/**
+ * @brief 持续打开 /proc/meminfo，每次采样从头 pread 到栈上的缓冲区并就地解析，
+ * 采样过程不分配内存
+ */
+class MemInfoSampler
 {
 public:
-    explicit MemInfo();
-    MemInfo(const MemInfo &other);
-    MemInfo &operator=(const MemInfo &rhs);
-    ~MemInfo();
-
-    qulonglong memTotal() const;
-    qulonglong memAvailable() const;
-    qulonglong buffers() const;
-    qulonglong cached() const;
-    qulonglong active() const;
-    qulonglong inactive() const;
-
-    qulonglong swapTotal() const;
-    qulonglong swapFree() const;
-    qulonglong swapCached() const;
-    qulonglong shmem() const;
-    qulonglong slab() const;
-    qulonglong dirty() const;
-    qulonglong mapped() const;
-
-    void readMemInfo();
+    explicit MemInfoSampler(const char *path = "/proc/meminfo");
+    ~MemInfoSampler();
+    MemInfoSampler(const MemInfoSampler &) = delete;
+    MemInfoSampler &operator=(const MemInfoSampler &) = delete;
+
+    bool isValid() const;
+    // 读取失败时保留上一次的数据并返回false
+    bool sample(MemInfo &info);
+
+    static bool parse(const char *data, const int size, MemInfo &info);
 
 private:
-    QSharedDataPointer<MemInfoPrivate> d;
+    int m_fd = -1;
 };
 
 } // namespace system
@@ -0,0 +1,115 @@
+/*
+ * Copyright (C) 2022 UnionTech Technology Co., Ltd.
+ *
+ * Author:     yeshanshan <yeshanshan@uniontech.com>
+ *
+ * Maintainer: yeshanshan <yeshanshan@uniontech.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "memoryhistory.h"
+
+#include <QtMath>
+
+namespace core {
+namespace system {
+
+quint16 MemoryHistory::toFixed(const qreal percent)
+{
+    if (!(percent > 0))
+        return 0;
+    return static_cast<quint16>(qMin<qreal>(FullScale, qRound(percent * FullScale / 100)));
+}
+
+qreal MemoryHistory::toPercent(const quint16 value)
+{
+    return value * 100. / FullScale;
+}
+
+void MemoryHistory::append(const quint16 memory, const quint16 swap, const int repeat)
+{
+    for (int i = 0; i < repeat; ++i) {
+        m_rings[Second].push({memory, swap});
+
+        m_memorySum += memory;
+        m_swapSum += swap;
+        if (++m_pending < DownsampleFactor)
+            continue;
+
+        m_rings[Minute].push({static_cast<quint16>(m_memorySum / m_pending),
+                              static_cast<quint16>(m_swapSum / m_pending)});
+        m_memorySum = 0;
+        m_swapSum = 0;
+        m_pending = 0;
+    }
+}
+
+void MemoryHistory::clear()
+{
+    for (auto &ring : m_rings) {
+        ring.head = 0;
+        ring.count = 0;
+        ring.appended = 0;
+    }
+    m_memorySum = 0;
+    m_swapSum = 0;
+    m_pending = 0;
+}
+
+int MemoryHistory::capacity(const Resolution resolution) const
+{
+    return m_rings[resolution].capacity;
+}
+
+int MemoryHistory::count(const Resolution resolution) const
+{
+    return m_rings[resolution].count;
+}
+
+MemoryHistory::Sample MemoryHistory::at(const Resolution resolution, const int index) const
+{
+    const auto &ring = m_rings[resolution];
+    if (index < 0 || index >= ring.count)
+        return Sample();
+    return ring.at(index);
+}
+
+MemoryHistory::Sample MemoryHistory::last(const Resolution resolution) const
+{
+    return at(resolution, m_rings[resolution].count - 1);
+}
+
+quint64 MemoryHistory::appended(const Resolution resolution) const
+{
+    return m_rings[resolution].appended;
+}
+
+void MemoryHistory::Ring::push(const Sample &sample)
+{
+    data[head] = sample;
+    head = (head + 1) % capacity;
+    if (count < capacity)
+        ++count;
+    ++appended;
+}
+
+const MemoryHistory::Sample &MemoryHistory::Ring::at(const int index) const
+{
+    // 最早的记录位于 head - count
+    return data[(head - count + index + capacity) % capacity];
+}
+
+} // namespace system
+} // namespace core
@@ -0,0 +1,96 @@
+/*
+ * Copyright (C) 2022 UnionTech Technology Co., Ltd.
+ *
+ * Author:     yeshanshan <yeshanshan@uniontech.com>
+ *
+ * Maintainer: yeshanshan <yeshanshan@uniontech.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <QtGlobal>
+
+namespace core {
+namespace system {
+
+/**
+ * @brief 内存使用率的历史记录，预先分配固定容量的环形缓冲区，
+ * 使用率以万分比的定点数保存，记录过程不分配内存
+ */
+class MemoryHistory
+{
+public:
+    enum Resolution {
+        Second = 0,   // 原始采样，保存最近一小时
+        Minute,       // 每60个采样取平均，保存最近一天
+        ResolutionCount
+    };
+
+    struct Sample {
+        quint16 memory = 0;  // 0 ~ FullScale
+        quint16 swap = 0;
+    };
+
+    static constexpr quint16 FullScale = 10000;
+    static constexpr int SecondCapacity = 3600;
+    static constexpr int MinuteCapacity = 1440;
+    static constexpr int DownsampleFactor = 60;
+
+    MemoryHistory() = default;
+    Q_DISABLE_COPY(MemoryHistory)
+
+    static quint16 toFixed(const qreal percent);
+    static qreal toPercent(const quint16 value);
+
+    // repeat 用于采样间隔大于1秒时补齐中间的记录
+    void append(const quint16 memory, const quint16 swap, const int repeat = 1);
+    void clear();
+
+    int capacity(const Resolution resolution) const;
+    int count(const Resolution resolution) const;
+    // index为0时是最早的记录
+    Sample at(const Resolution resolution, const int index) const;
+    Sample last(const Resolution resolution) const;
+    // 累计写入的记录数，用于增量绘制时判断新增了多少记录
+    quint64 appended(const Resolution resolution) const;
+
+private:
+    struct Ring {
+        Sample *data = nullptr;
+        int capacity = 0;
+        int head = 0;   // 下一个写入位置
+        int count = 0;
+        quint64 appended = 0;
+
+        void push(const Sample &sample);
+        const Sample &at(const int index) const;
+    };
+
+    Sample m_seconds[SecondCapacity];
+    Sample m_minutes[MinuteCapacity];
+    Ring m_rings[ResolutionCount] = {
+        {m_seconds, SecondCapacity},
+        {m_minutes, MinuteCapacity}
+    };
+
+    // 降采样的累加值
+    quint32 m_memorySum = 0;
+    quint32 m_swapSum = 0;
+    int m_pending = 0;
+};
+
+} // namespace system
+} // namespace core
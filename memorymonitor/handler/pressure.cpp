@@ -0,0 +1,187 @@
+/*
+ * Copyright (C) 2022 UnionTech Technology Co., Ltd.
+ *
+ * Author:     yeshanshan <yeshanshan@uniontech.com>
+ *
+ * Maintainer: yeshanshan <yeshanshan@uniontech.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "pressure.h"
+
+#include <QDebug>
+#include <QSocketNotifier>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+namespace core {
+namespace system {
+
+// 解析形如 "12.34" 的数值，与区域设置无关；缓冲区截断在数字中间时不更新
+static const char *parseNumber(const char *p, const char *end, qreal &value)
+{
+    qulonglong integer = 0;
+    while (p < end && *p >= '0' && *p <= '9')
+        integer = integer * 10 + qulonglong(*p++ - '0');
+
+    qreal fraction = 0;
+    if (p < end && *p == '.') {
+        qreal scale = 0.1;
+        for (++p; p < end && *p >= '0' && *p <= '9'; ++p, scale /= 10)
+            fraction += (*p - '0') * scale;
+    }
+    if (p < end)
+        value = integer + fraction;
+    return p;
+}
+
+// 匹配成功时跳过该字段名
+template<int N>
+static bool consumeKey(const char *&p, const char *end, const char (&key)[N])
+{
+    if (end - p < N - 1 || memcmp(p, key, N - 1))
+        return false;
+    p += N - 1;
+    return true;
+}
+
+// 解析 "avg10=0.00 avg60=0.00 avg300=0.00 total=0"
+static const char *parseStall(const char *p, const char *end, PressureStall &stall)
+{
+    while (p < end && *p != '\n') {
+        while (p < end && *p == ' ')
+            ++p;
+
+        if (consumeKey(p, end, "avg10=")) {
+            p = parseNumber(p, end, stall.avg10);
+        } else if (consumeKey(p, end, "avg60=")) {
+            p = parseNumber(p, end, stall.avg60);
+        } else if (consumeKey(p, end, "avg300=")) {
+            p = parseNumber(p, end, stall.avg300);
+        } else if (consumeKey(p, end, "total=")) {
+            qulonglong total = 0;
+            while (p < end && *p >= '0' && *p <= '9')
+                total = total * 10 + qulonglong(*p++ - '0');
+            if (p < end)
+                stall.total = total;
+        } else {
+            while (p < end && *p != ' ' && *p != '\n')
+                ++p;
+        }
+    }
+    return p;
+}
+
+PressureSampler::PressureSampler(const char *path)
+{
+    // 内核未开启 PSI 是常见情况，不输出警告
+    m_fd = open(path, O_RDONLY | O_CLOEXEC);
+}
+
+PressureSampler::~PressureSampler()
+{
+    if (m_fd >= 0)
+        close(m_fd);
+}
+
+bool PressureSampler::isValid() const
+{
+    return m_fd >= 0;
+}
+
+bool PressureSampler::sample(PressureInfo &info)
+{
+    if (m_fd < 0)
+        return false;
+
+    char buffer[256];
+    const ssize_t size = pread(m_fd, buffer, sizeof(buffer), 0);
+    if (size <= 0)
+        return false;
+
+    return parse(buffer, int(size), info);
+}
+
+bool PressureSampler::parse(const char *data, const int size, PressureInfo &info)
+{
+    const char *p = data;
+    const char *end = data + size;
+    bool hasSome = false;
+    while (p < end) {
+        if (consumeKey(p, end, "some ")) {
+            p = parseStall(p, end, info.some);
+            hasSome = true;
+        } else if (consumeKey(p, end, "full ")) {
+            p = parseStall(p, end, info.full);
+        }
+
+        while (p < end && *p != '\n')
+            ++p;
+        ++p;
+    }
+    return hasSome;
+}
+
+PressureTrigger::PressureTrigger(const qint64 stallUs, const qint64 windowUs, const char *path, QObject *parent)
+    : QObject(parent)
+    , m_window(windowUs)
+{
+    do {
+        m_fd = open(path, O_RDWR | O_NONBLOCK | O_CLOEXEC);
+        if (m_fd < 0)
+            break;
+
+        char trigger[64];
+        const int length = snprintf(trigger, sizeof(trigger), "some %lld %lld",
+                                    static_cast<long long>(stallUs), static_cast<long long>(windowUs));
+        // 写入的内容需要包含结尾的'\0'
+        if (write(m_fd, trigger, size_t(length) + 1) < 0) {
+            qDebug() << "register psi trigger failed:" << strerror(errno);
+            close(m_fd);
+            m_fd = -1;
+            break;
+        }
+
+        // 内核以 POLLPRI 通知
+        m_notifier = new QSocketNotifier(m_fd, QSocketNotifier::Exception, this);
+        connect(m_notifier, &QSocketNotifier::activated, this, &PressureTrigger::triggered);
+    } while (false);
+}
+
+PressureTrigger::~PressureTrigger()
+{
+    if (m_notifier)
+        m_notifier->setEnabled(false);
+    // 关闭文件即注销触发器
+    if (m_fd >= 0)
+        close(m_fd);
+}
+
+bool PressureTrigger::isValid() const
+{
+    return m_fd >= 0;
+}
+
+qint64 PressureTrigger::window() const
+{
+    return m_window;
+}
+
+} // namespace system
+} // namespace core
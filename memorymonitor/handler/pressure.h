@@ -0,0 +1,92 @@
+/*
+ * Copyright (C) 2022 UnionTech Technology Co., Ltd.
+ *
+ * Author:     yeshanshan <yeshanshan@uniontech.com>
+ *
+ * Maintainer: yeshanshan <yeshanshan@uniontech.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <QObject>
+
+class QSocketNotifier;
+
+namespace core {
+namespace system {
+
+// PSI 文件中一行的数据，avg为停顿时间的百分比，total单位为微秒
+struct PressureStall {
+    qreal avg10 = 0;
+    qreal avg60 = 0;
+    qreal avg300 = 0;
+    qulonglong total = 0;
+};
+
+// /proc/pressure/memory 的内容，some为至少有一个任务停顿，full为所有任务都停顿
+struct PressureInfo {
+    PressureStall some;
+    PressureStall full;
+};
+
+/**
+ * @brief 持续打开 PSI 文件，和 MemInfoSampler 一样就地解析，不分配内存
+ */
+class PressureSampler
+{
+public:
+    explicit PressureSampler(const char *path = "/proc/pressure/memory");
+    ~PressureSampler();
+    PressureSampler(const PressureSampler &) = delete;
+    PressureSampler &operator=(const PressureSampler &) = delete;
+
+    // 内核未开启 PSI 时无效
+    bool isValid() const;
+    bool sample(PressureInfo &info);
+
+    static bool parse(const char *data, const int size, PressureInfo &info);
+
+private:
+    int m_fd = -1;
+};
+
+/**
+ * @brief 在 PSI 文件上注册触发器，停顿时间在窗口内超过阈值时由内核唤醒，
+ * 不需要轮询；没有权限或内核不支持时 isValid() 返回false
+ */
+class PressureTrigger : public QObject
+{
+    Q_OBJECT
+public:
+    // 非特权进程注册时窗口须为2秒的整数倍
+    explicit PressureTrigger(const qint64 stallUs = 150000, const qint64 windowUs = 2000000,
+                             const char *path = "/proc/pressure/memory", QObject *parent = nullptr);
+    virtual ~PressureTrigger() override;
+
+    bool isValid() const;
+    qint64 window() const;
+
+Q_SIGNALS:
+    void triggered();
+
+private:
+    int m_fd = -1;
+    qint64 m_window = 0;
+    QSocketNotifier *m_notifier = nullptr;
+};
+
+} // namespace system
+} // namespace core
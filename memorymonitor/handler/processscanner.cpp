@@ -0,0 +1,468 @@
+/*
+ * Copyright (C) 2022 UnionTech Technology Co., Ltd.
+ *
+ * Author:     yeshanshan <yeshanshan@uniontech.com>
+ *
+ * Maintainer: yeshanshan <yeshanshan@uniontech.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "processscanner.h"
+#include "common/utils.h"
+#include "common/flatpakresolver.h"
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QTimerEvent>
+
+#include <algorithm>
+#include <vector>
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+namespace core {
+namespace system {
+
+// 读取 /proc/<pid>/ 下的小文件，只在解析新进程时使用
+static QByteArray readProcFile(const pid_t pid, const char *name)
+{
+    QFile file(QString("/proc/%1/%2").arg(pid).arg(name));
+    if (!file.open(QIODevice::ReadOnly))
+        return QByteArray();
+    return file.readAll();
+}
+
+// 从 environ 中查找变量，没有权限读取时返回空
+static QByteArray environmentValue(const QByteArray &environ, const QByteArray &name)
+{
+    const QByteArray prefix = name + '=';
+    for (const auto &item : environ.split('\0')) {
+        if (item.startsWith(prefix))
+            return item.mid(prefix.size());
+    }
+    return QByteArray();
+}
+
+// desktop 文件中 [Desktop Entry] 的 Icon 字段
+static QString desktopFileIcon(const QString &desktopFile)
+{
+    QFile file(desktopFile);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
+        return QString();
+
+    bool inEntry = false;
+    while (!file.atEnd()) {
+        const QByteArray line = file.readLine().trimmed();
+        if (line.startsWith('[')) {
+            if (inEntry)
+                break;
+            inEntry = line == "[Desktop Entry]";
+        } else if (inEntry && line.startsWith("Icon=")) {
+            return QString::fromUtf8(line.mid(5).trimmed());
+        }
+    }
+    return QString();
+}
+
+ProcessScanWorker::ProcessScanWorker(QObject *parent)
+    : QObject(parent)
+{
+}
+
+void ProcessScanWorker::start(const int interval)
+{
+    m_timer.start(interval, this);
+    scan();
+}
+
+void ProcessScanWorker::stop()
+{
+    m_timer.stop();
+    // 停止期间 pid 可能被复用，恢复时重新解析
+    m_records.clear();
+    m_records.squeeze();
+    m_desktopIcons.clear();
+}
+
+void ProcessScanWorker::setOptions(const int topCount, const int metric)
+{
+    m_topCount = qMax(1, topCount);
+    m_metric = static_cast<Metric>(metric);
+    if (m_timer.isActive())
+        scan();
+}
+
+void ProcessScanWorker::scan()
+{
+    QElapsedTimer cost;
+    cost.start();
+
+    static const long pageKB = qMax(1L, sysconf(_SC_PAGESIZE) / 1024);
+    ++m_generation;
+    m_candidates.clear();
+
+    DIR *dir = opendir("/proc");
+    if (!dir)
+        return;
+
+    while (const dirent *entry = readdir(dir)) {
+        const char *p = entry->d_name;
+        if (*p < '1' || *p > '9')
+            continue;
+
+        pid_t pid = 0;
+        for (; *p >= '0' && *p <= '9'; ++p)
+            pid = pid * 10 + (*p - '0');
+        if (*p != '\0')
+            continue;
+
+        // 内核线程没有用户态内存，不参与统计
+        qulonglong rss = 0;
+        if (!readRss(pid, pageKB, rss) || rss == 0)
+            continue;
+
+        auto iter = m_records.find(pid);
+        if (iter == m_records.end()) {
+            iter = m_records.insert(pid, Record());
+            resolve(pid, iter.value());
+        }
+        iter->rss = rss;
+        iter->generation = m_generation;
+        m_candidates.emplace_back(rss, pid);
+    }
+    closedir(dir);
+
+    // 清理已退出的进程
+    for (auto iter = m_records.begin(); iter != m_records.end();) {
+        if (iter->generation != m_generation)
+            iter = m_records.erase(iter);
+        else
+            ++iter;
+    }
+
+    // 只需要前几名，不做全排序
+    auto byMemory = [](const Candidate &left, const Candidate &right) {
+        return left.first > right.first;
+    };
+    const int rssCount = qMin<int>(int(m_candidates.size()), m_metric == Pss ? m_topCount * 2 : m_topCount);
+    std::partial_sort(m_candidates.begin(), m_candidates.begin() + rssCount, m_candidates.end(), byMemory);
+    m_candidates.resize(size_t(rssCount));
+
+    if (m_metric == Pss) {
+        for (auto &candidate : m_candidates) {
+            qulonglong pss = 0;
+            // 没有权限读取 smaps_rollup 时以RSS代替
+            if (readPss(candidate.second, pss))
+                candidate.first = pss;
+        }
+        std::sort(m_candidates.begin(), m_candidates.end(), byMemory);
+    }
+
+    QVector<ProcessEntry> top;
+    top.reserve(m_topCount);
+    for (const auto &candidate : m_candidates) {
+        if (top.size() >= m_topCount)
+            break;
+        const auto &record = m_records[candidate.second];
+        ProcessEntry process;
+        process.pid = candidate.second;
+        process.name = record.name;
+        process.icon = record.icon;
+        process.rss = record.rss;
+        process.pss = m_metric == Pss ? candidate.first : 0;
+        top << process;
+    }
+
+    Q_EMIT scanned(top, cost.nsecsElapsed() / 1000);
+}
+
+void ProcessScanWorker::timerEvent(QTimerEvent *event)
+{
+    if (event->timerId() == m_timer.timerId()) {
+        scan();
+        return;
+    }
+    return QObject::timerEvent(event);
+}
+
+void ProcessScanWorker::resolve(const pid_t pid, Record &record)
+{
+    const QString comm = QString::fromUtf8(readProcFile(pid, "comm").trimmed());
+    QByteArrayList cmdline = readProcFile(pid, "cmdline").split('\0');
+    cmdline.removeAll(QByteArray());
+    record.name = Utils::normalizeProcName(comm, cmdline);
+
+    // 优先使用启动该进程的 desktop 文件中的图标
+    const QByteArray environ = readProcFile(pid, "environ");
+    const QString desktopFile = QString::fromUtf8(environmentValue(environ, "GIO_LAUNCHED_DESKTOP_FILE"));
+    if (!desktopFile.isEmpty()) {
+        auto iter = m_desktopIcons.find(desktopFile);
+        if (iter == m_desktopIcons.end())
+            iter = m_desktopIcons.insert(desktopFile, desktopFileIcon(desktopFile));
+        record.icon = iter.value();
+    }
+    // flatpak 应用使用部署目录中导出的图标
+    if (record.icon.isEmpty()) {
+        const QString flatpakId = QString::fromUtf8(environmentValue(environ, "FLATPAK_ID"));
+        if (!flatpakId.isEmpty()) {
+            const auto &info = Utils::FlatpakResolver::instance()->lookup(flatpakId);
+            record.icon = info.icon.isEmpty() ? flatpakId : info.icon;
+            if (!info.name.isEmpty())
+                record.name = info.name;
+        }
+    }
+}
+
+bool ProcessScanWorker::readRss(const pid_t pid, const long pageKB, qulonglong &rss)
+{
+    char path[32];
+    snprintf(path, sizeof(path), "/proc/%d/statm", pid);
+    const int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+        return false;
+
+    char buffer[128];
+    const ssize_t size = read(fd, buffer, sizeof(buffer) - 1);
+    close(fd);
+    if (size <= 0)
+        return false;
+    buffer[size] = '\0';
+
+    // statm: size resident shared text lib data dt，单位为页
+    const char *p = buffer;
+    while (*p >= '0' && *p <= '9')
+        ++p;
+    if (*p++ != ' ')
+        return false;
+
+    qulonglong pages = 0;
+    for (; *p >= '0' && *p <= '9'; ++p)
+        pages = pages * 10 + qulonglong(*p - '0');
+    rss = pages * qulonglong(pageKB);
+    return true;
+}
+
+bool ProcessScanWorker::readPss(const pid_t pid, qulonglong &pss)
+{
+    char path[40];
+    snprintf(path, sizeof(path), "/proc/%d/smaps_rollup", pid);
+    const int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+        return false;
+
+    char buffer[1024];
+    const ssize_t size = read(fd, buffer, sizeof(buffer) - 1);
+    close(fd);
+    if (size <= 0)
+        return false;
+    buffer[size] = '\0';
+
+    const char *p = strstr(buffer, "\nPss:");
+    if (!p)
+        return false;
+    for (p += 5; *p == ' '; ++p) { }
+
+    qulonglong value = 0;
+    for (; *p >= '0' && *p <= '9'; ++p)
+        value = value * 10 + qulonglong(*p - '0');
+    pss = value;
+    return true;
+}
+
+ProcessScanner *ProcessScanner::instance()
+{
+    static ProcessScanner *gInstance = nullptr;
+    if (!gInstance)
+        gInstance = new ProcessScanner();
+    return gInstance;
+}
+
+ProcessScanner::ProcessScanner(QObject *parent)
+    : QObject(parent)
+{
+    qRegisterMetaType<core::system::ProcessEntry>();
+    qRegisterMetaType<QVector<core::system::ProcessEntry>>();
+    // 解析器需要在主线程中创建，工作线程中只调用 lookup
+    Utils::FlatpakResolver::instance();
+
+    m_thread.setObjectName("ProcessScanner");
+    m_worker = new ProcessScanWorker();
+    m_worker->moveToThread(&m_thread);
+    connect(&m_thread, &QThread::finished, m_worker, &QObject::deleteLater);
+    connect(m_worker, &ProcessScanWorker::scanned, this, &ProcessScanner::onScanned);
+    connect(qApp, &QCoreApplication::aboutToQuit, this, [this]() {
+        m_thread.quit();
+        m_thread.wait();
+    });
+}
+
+ProcessScanner::~ProcessScanner()
+{
+    m_thread.quit();
+    m_thread.wait();
+}
+
+void ProcessScanner::setSubscriberActive(QObject *subscriber, const bool active,
+                                         const ProcessScanWorker::Metric metric)
+{
+    if (!subscriber)
+        return;
+
+    auto iter = m_subscribers.find(subscriber);
+    if (active) {
+        if (iter != m_subscribers.end()) {
+            if (iter.value() != metric) {
+                iter.value() = metric;
+                updateMetric();
+            }
+            return;
+        }
+        m_subscribers.insert(subscriber, metric);
+        connect(subscriber, &QObject::destroyed, this, [this, subscriber]() {
+            setSubscriberActive(subscriber, false);
+        });
+    } else {
+        if (iter == m_subscribers.end())
+            return;
+        m_subscribers.erase(iter);
+        disconnect(subscriber, &QObject::destroyed, this, nullptr);
+    }
+    // 先更新排序依据再启动，首次扫描即使用正确的指标
+    updateMetric();
+    updateWorker();
+}
+
+bool ProcessScanner::isRunning() const
+{
+    return m_running;
+}
+
+int ProcessScanner::interval() const
+{
+    return m_interval;
+}
+
+void ProcessScanner::setInterval(const int msecs)
+{
+    if (m_interval == msecs || msecs <= 0)
+        return;
+
+    m_interval = msecs;
+    if (m_running) {
+        auto worker = m_worker;
+        QMetaObject::invokeMethod(worker, [worker, msecs]() {
+            worker->start(msecs);
+        }, Qt::QueuedConnection);
+    }
+}
+
+int ProcessScanner::topCount() const
+{
+    return m_topCount;
+}
+
+void ProcessScanner::setTopCount(const int count)
+{
+    if (m_topCount == count || count <= 0)
+        return;
+
+    m_topCount = count;
+    auto worker = m_worker;
+    const int metric = m_metric;
+    QMetaObject::invokeMethod(worker, [worker, count, metric]() {
+        worker->setOptions(count, metric);
+    }, Qt::QueuedConnection);
+}
+
+ProcessScanWorker::Metric ProcessScanner::metric() const
+{
+    return m_metric;
+}
+
+const QVector<ProcessEntry> &ProcessScanner::topProcesses() const
+{
+    return m_top;
+}
+
+qint64 ProcessScanner::lastScanCost() const
+{
+    return m_lastScanCost;
+}
+
+void ProcessScanner::updateWorker()
+{
+    const bool running = !m_subscribers.isEmpty();
+    if (m_running == running)
+        return;
+
+    m_running = running;
+    auto worker = m_worker;
+    if (running) {
+        if (!m_thread.isRunning())
+            m_thread.start(QThread::LowPriority);
+        const int interval = m_interval;
+        QMetaObject::invokeMethod(worker, [worker, interval]() {
+            worker->start(interval);
+        }, Qt::QueuedConnection);
+    } else {
+        QMetaObject::invokeMethod(worker, [worker]() {
+            worker->stop();
+        }, Qt::QueuedConnection);
+        m_top.clear();
+    }
+}
+
+void ProcessScanner::updateMetric()
+{
+    // 没有订阅者时保留上次的设置，避免重新订阅时多发一次
+    if (m_subscribers.isEmpty())
+        return;
+
+    ProcessScanWorker::Metric metric = ProcessScanWorker::Rss;
+    for (auto value : qAsConst(m_subscribers)) {
+        if (value == ProcessScanWorker::Pss) {
+            metric = ProcessScanWorker::Pss;
+            break;
+        }
+    }
+    if (m_metric == metric)
+        return;
+
+    m_metric = metric;
+    auto worker = m_worker;
+    const int count = m_topCount;
+    QMetaObject::invokeMethod(worker, [worker, count, metric]() {
+        worker->setOptions(count, metric);
+    }, Qt::QueuedConnection);
+}
+
+void ProcessScanner::onScanned(const QVector<ProcessEntry> &top, const qint64 costUs)
+{
+    // 停止后仍在队列中的结果直接丢弃
+    if (!m_running)
+        return;
+
+    m_top = top;
+    m_lastScanCost = costUs;
+    Q_EMIT updated();
+}
+
+} // namespace system
+} // namespace core
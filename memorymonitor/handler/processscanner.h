@@ -0,0 +1,155 @@
+/*
+ * Copyright (C) 2022 UnionTech Technology Co., Ltd.
+ *
+ * Author:     yeshanshan <yeshanshan@uniontech.com>
+ *
+ * Maintainer: yeshanshan <yeshanshan@uniontech.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <QObject>
+#include <QHash>
+#include <QVector>
+#include <QBasicTimer>
+#include <QThread>
+
+#include <vector>
+#include <utility>
+
+#include <sys/types.h>
+
+namespace core {
+namespace system {
+
+// 占用内存最多的进程，内存单位为KB
+struct ProcessEntry {
+    pid_t pid = 0;
+    QString name;
+    // 主题图标名或图标文件路径，为空时使用默认图标
+    QString icon;
+    qulonglong rss = 0;
+    qulonglong pss = 0;
+
+    bool operator==(const ProcessEntry &other) const
+    {
+        return pid == other.pid && rss == other.rss && pss == other.pss
+                && name == other.name && icon == other.icon;
+    }
+};
+
+/**
+ * @brief 在工作线程中扫描 /proc 的对象，维护 pid 到进程记录的表，
+ * 名称、图标等只在 pid 首次出现时解析一次，之后每轮只读取 statm
+ */
+class ProcessScanWorker : public QObject
+{
+    Q_OBJECT
+public:
+    enum Metric {
+        Rss,
+        Pss     // 只对按RSS排序的前几名读取 smaps_rollup
+    };
+
+    explicit ProcessScanWorker(QObject *parent = nullptr);
+
+public Q_SLOTS:
+    void start(const int interval);
+    void stop();
+    void setOptions(const int topCount, const int metric);
+    void scan();
+
+Q_SIGNALS:
+    void scanned(const QVector<core::system::ProcessEntry> &top, const qint64 costUs);
+
+protected:
+    virtual void timerEvent(QTimerEvent *event) override;
+
+private:
+    struct Record {
+        QString name;
+        QString icon;
+        qulonglong rss = 0;
+        quint32 generation = 0;
+    };
+
+    // (内存, pid)
+    using Candidate = std::pair<qulonglong, pid_t>;
+
+    void resolve(const pid_t pid, Record &record);
+    static bool readRss(const pid_t pid, const long pageKB, qulonglong &rss);
+    static bool readPss(const pid_t pid, qulonglong &pss);
+
+    QHash<pid_t, Record> m_records;
+    // 同一个 desktop 文件启动的进程共用图标
+    QHash<QString, QString> m_desktopIcons;
+    std::vector<Candidate> m_candidates;
+    quint32 m_generation = 0;
+    int m_topCount = 5;
+    Metric m_metric = Rss;
+    QBasicTimer m_timer;
+};
+
+/**
+ * @brief 进程内共享的进程扫描器，有可见的订阅者时在后台线程周期扫描
+ */
+class ProcessScanner : public QObject
+{
+    Q_OBJECT
+public:
+    static ProcessScanner *instance();
+    virtual ~ProcessScanner() override;
+
+    // 订阅者销毁后自动取消，任一活跃的订阅者需要 PSS 时按 PSS 排序
+    void setSubscriberActive(QObject *subscriber, const bool active,
+                             const ProcessScanWorker::Metric metric = ProcessScanWorker::Rss);
+    bool isRunning() const;
+
+    int interval() const;
+    void setInterval(const int msecs);
+    int topCount() const;
+    void setTopCount(const int count);
+    ProcessScanWorker::Metric metric() const;
+
+    const QVector<ProcessEntry> &topProcesses() const;
+    // 最近一次扫描的耗时，单位为微秒
+    qint64 lastScanCost() const;
+
+Q_SIGNALS:
+    void updated();
+
+private:
+    explicit ProcessScanner(QObject *parent = nullptr);
+    void updateWorker();
+    void updateMetric();
+    void onScanned(const QVector<ProcessEntry> &top, const qint64 costUs);
+
+    QHash<QObject *, ProcessScanWorker::Metric> m_subscribers;
+    QThread m_thread;
+    ProcessScanWorker *m_worker = nullptr;
+    bool m_running = false;
+    int m_interval = 2000;
+    int m_topCount = 5;
+    ProcessScanWorker::Metric m_metric = ProcessScanWorker::Rss;
+
+    QVector<ProcessEntry> m_top;
+    qint64 m_lastScanCost = 0;
+};
+
+} // namespace system
+} // namespace core
+
+Q_DECLARE_METATYPE(core::system::ProcessEntry)
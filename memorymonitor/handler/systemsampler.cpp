@@ -0,0 +1,432 @@
+/*
+ * Copyright (C) 2022 UnionTech Technology Co., Ltd.
+ *
+ * Author:     yeshanshan <yeshanshan@uniontech.com>
+ *
+ * Maintainer: yeshanshan <yeshanshan@uniontech.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "systemsampler.h"
+
+#include <widgetsinstrumentation.h>
+
+#include <QDateTime>
+#include <QDebug>
+#include <QTimerEvent>
+
+namespace core {
+namespace system {
+
+SystemSampler *SystemSampler::instance()
+{
+    static SystemSampler *gInstance = nullptr;
+    if (!gInstance)
+        gInstance = new SystemSampler();
+    return gInstance;
+}
+
+SystemSampler::SystemSampler(QObject *parent)
+    : QObject(parent)
+{
+    // 只在变化时更新，初始值需要先发布一次
+    Widgets::Instrumentation::instance()->setMetric("memoryMonitor.sampleInterval", m_effectiveInterval);
+}
+
+void SystemSampler::subscribe(QObject *subscriber)
+{
+    if (!subscriber || m_subscribers.contains(subscriber))
+        return;
+
+    m_subscribers.insert(subscriber, false);
+    connect(subscriber, &QObject::destroyed, this, [this, subscriber]() {
+        unsubscribe(subscriber);
+    });
+}
+
+void SystemSampler::unsubscribe(QObject *subscriber)
+{
+    auto iter = m_subscribers.find(subscriber);
+    if (iter == m_subscribers.end())
+        return;
+
+    if (iter.value())
+        --m_activeCount;
+    m_subscribers.erase(iter);
+    m_cgroupSubscribers.remove(subscriber);
+    m_intervalBounds.remove(subscriber);
+    disconnect(subscriber, &QObject::destroyed, this, nullptr);
+    updateIntervalBounds();
+    updateTimer();
+}
+
+void SystemSampler::setSubscriberActive(QObject *subscriber, const bool active)
+{
+    auto iter = m_subscribers.find(subscriber);
+    if (iter == m_subscribers.end() || iter.value() == active)
+        return;
+
+    iter.value() = active;
+    m_activeCount += active ? 1 : -1;
+    updateIntervalBounds();
+    updateTimer();
+}
+
+void SystemSampler::setSubscriberCgroup(QObject *subscriber, const bool enabled)
+{
+    if (!m_subscribers.contains(subscriber) || m_cgroupSubscribers.contains(subscriber) == enabled)
+        return;
+
+    if (!enabled) {
+        m_cgroupSubscribers.remove(subscriber);
+        return;
+    }
+
+    m_cgroupSubscribers.insert(subscriber);
+    // 路径只解析一次，之后文件一直保持打开
+    if (!m_cgroupSampler) {
+        m_cgroupSampler.reset(new CgroupSampler());
+        qDebug() << "cgroup accounting path:" << m_cgroupSampler->path();
+    }
+    if (m_timer.isActive())
+        sampleCgroup();
+}
+
+int SystemSampler::activeCount() const
+{
+    return m_activeCount;
+}
+
+bool SystemSampler::isRunning() const
+{
+    return m_timer.isActive();
+}
+
+int SystemSampler::interval() const
+{
+    return m_interval;
+}
+
+void SystemSampler::setInterval(const int msecs)
+{
+    if (m_interval == msecs || msecs <= 0)
+        return;
+
+    m_interval = msecs;
+    setEffectiveInterval(m_interval);
+}
+
+int SystemSampler::minInterval() const
+{
+    return m_minInterval;
+}
+
+int SystemSampler::maxInterval() const
+{
+    return m_maxInterval;
+}
+
+void SystemSampler::setSubscriberIntervalBounds(QObject *subscriber, const int minMsecs, const int maxMsecs)
+{
+    if (!m_subscribers.contains(subscriber) || minMsecs <= 0 || maxMsecs < minMsecs)
+        return;
+
+    const auto bounds = qMakePair(minMsecs, maxMsecs);
+    auto iter = m_intervalBounds.find(subscriber);
+    if (iter != m_intervalBounds.end() && iter.value() == bounds)
+        return;
+
+    m_intervalBounds.insert(subscriber, bounds);
+    updateIntervalBounds();
+}
+
+int SystemSampler::effectiveInterval() const
+{
+    return m_effectiveInterval;
+}
+
+void SystemSampler::setEffectiveInterval(const int msecs)
+{
+    const int interval = qBound(m_minInterval, msecs, m_maxInterval);
+    if (m_effectiveInterval == interval)
+        return;
+
+    m_effectiveInterval = interval;
+    restartTimer();
+    Widgets::Instrumentation::instance()->setMetric("memoryMonitor.sampleInterval", m_effectiveInterval);
+}
+
+const MemInfo &SystemSampler::memInfo() const
+{
+    return m_memInfo;
+}
+
+const MemoryHistory &SystemSampler::history() const
+{
+    return m_history;
+}
+
+bool SystemSampler::hasPressure() const
+{
+    return m_pressureSampler.isValid();
+}
+
+const PressureInfo &SystemSampler::pressure() const
+{
+    return m_pressure;
+}
+
+bool SystemSampler::isEventDriven() const
+{
+    return m_trigger != nullptr;
+}
+
+bool SystemSampler::isPressureHigh() const
+{
+    return m_pressureHigh;
+}
+
+const ZramInfo &SystemSampler::zramInfo() const
+{
+    return m_zramInfo;
+}
+
+bool SystemSampler::hasCgroup() const
+{
+    return m_cgroupSampler && m_cgroupSampler->isValid();
+}
+
+const CgroupMemInfo &SystemSampler::cgroupInfo() const
+{
+    return m_cgroupInfo;
+}
+
+bool SystemSampler::isCgroupThrottled() const
+{
+    return m_lastThrottled.isValid() && m_lastThrottled.elapsed() < ThrottleHoldTime;
+}
+
+void SystemSampler::timerEvent(QTimerEvent *event)
+{
+    if (event->timerId() == m_timer.timerId()) {
+        sample();
+        scheduleNext();
+        return;
+    }
+    return QObject::timerEvent(event);
+}
+
+void SystemSampler::updateTimer()
+{
+    if (m_activeCount <= 0) {
+        m_timer.stop();
+        // 触发器会让内核周期性地检查压力，不需要时注销
+        disarmTrigger();
+        m_historyClock.invalidate();
+        // 恢复时从正常间隔重新开始调整
+        m_lastUsage = -1;
+        setEffectiveInterval(m_interval);
+        return;
+    }
+    if (m_timer.isActive())
+        return;
+
+    armTrigger();
+    // 从停止状态恢复时立即采样一次，避免显示过期的数据
+    sample();
+    scheduleNext();
+}
+
+void SystemSampler::updateIntervalBounds()
+{
+    // 没有活跃的订阅者时保持原来的上下限
+    int minInterval = 0;
+    int maxInterval = 0;
+    for (auto iter = m_intervalBounds.constBegin(); iter != m_intervalBounds.constEnd(); ++iter) {
+        if (!m_subscribers.value(iter.key()))
+            continue;
+        minInterval = minInterval > 0 ? qMin(minInterval, iter.value().first) : iter.value().first;
+        maxInterval = qMax(maxInterval, iter.value().second);
+    }
+    if (minInterval <= 0)
+        return;
+    if (m_minInterval == minInterval && m_maxInterval == maxInterval)
+        return;
+
+    m_minInterval = minInterval;
+    m_maxInterval = maxInterval;
+    setEffectiveInterval(m_effectiveInterval);
+}
+
+void SystemSampler::restartTimer()
+{
+    if (m_timer.isActive())
+        scheduleNext();
+}
+
+void SystemSampler::scheduleNext()
+{
+    // 与宿主的 TickScheduler 相同，到期时刻对齐到系统时钟的整数倍，
+    // 和每秒刷新的组件在同一次唤醒中完成，相近的时刻合并
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+    const int interval = effectiveInterval();
+    const qint64 deadline = ((now + MergeTolerance) / interval + 1) * interval;
+    m_timer.start(int(deadline - now), Qt::PreciseTimer, this);
+}
+
+void SystemSampler::armTrigger()
+{
+    if (m_trigger || m_triggerUnsupported || !m_pressureSampler.isValid())
+        return;
+
+    m_trigger = new PressureTrigger(150000, 2000000, "/proc/pressure/memory", this);
+    if (!m_trigger->isValid()) {
+        // 内核不支持或没有权限，之后一直轮询
+        qDebug() << "psi trigger is unavailable, fall back to polling.";
+        delete m_trigger;
+        m_trigger = nullptr;
+        m_triggerUnsupported = true;
+        return;
+    }
+    connect(m_trigger, &PressureTrigger::triggered, this, &SystemSampler::onPressureTriggered);
+}
+
+void SystemSampler::disarmTrigger()
+{
+    delete m_trigger;
+    m_trigger = nullptr;
+}
+
+void SystemSampler::onPressureTriggered()
+{
+    m_lastTriggered.start();
+    setPressureHigh(true);
+    sample();
+}
+
+void SystemSampler::setPressureHigh(const bool high)
+{
+    if (m_pressureHigh == high)
+        return;
+
+    m_pressureHigh = high;
+    // 压力过高时以最快的频率采样
+    setEffectiveInterval(high ? m_minInterval : m_interval);
+    Q_EMIT pressureHighChanged(m_pressureHigh);
+}
+
+void SystemSampler::sample()
+{
+    if (!m_memSampler.sample(m_memInfo))
+        return;
+
+    if (m_pressureSampler.sample(m_pressure)) {
+        // 触发后至少保持一个触发窗口，避免反复切换
+        const bool recentlyTriggered = m_lastTriggered.isValid() &&
+                m_lastTriggered.elapsed() < (m_trigger ? m_trigger->window() / 1000 : 0);
+        if (m_pressure.some.avg10 >= HighPressure) {
+            setPressureHigh(true);
+        } else if (m_pressure.some.avg10 < ReleasePressure && !recentlyTriggered) {
+            setPressureHigh(false);
+        }
+    }
+
+    sampleZram();
+    sampleCgroup();
+    recordHistory();
+    adaptInterval();
+    Q_EMIT sampled();
+}
+
+void SystemSampler::adaptInterval()
+{
+    if (m_memInfo.memTotal == 0)
+        return;
+
+    const int usage = MemoryHistory::toFixed((m_memInfo.memTotal - m_memInfo.memAvailable) * 100. / m_memInfo.memTotal);
+    int next = m_interval;
+    if (m_pressureHigh) {
+        next = m_minInterval;
+    } else if (m_lastUsage >= 0 && m_lastSample.isValid()) {
+        // 每秒变化的万分比，快速变化时加快采样，稳定时逐步退避
+        const qint64 elapsed = qMax<qint64>(1, m_lastSample.elapsed());
+        const qint64 change = qAbs(usage - m_lastUsage) * 1000 / elapsed;
+        if (change >= FastChange) {
+            next = m_minInterval;
+        } else if (change <= StableChange) {
+            next = qMax(m_effectiveInterval, m_interval) * 2;
+        }
+    }
+
+    m_lastUsage = usage;
+    m_lastSample.start();
+    setEffectiveInterval(next);
+}
+
+void SystemSampler::sampleZram()
+{
+    if (m_memInfo.swapTotal != m_zramSwapTotal) {
+        m_zramSwapTotal = m_memInfo.swapTotal;
+        m_zramSampler.discover();
+    }
+
+    if (m_zramSampler.deviceCount() > 0)
+        m_zramSampler.sample(m_zramInfo);
+    else
+        m_zramInfo = ZramInfo();
+}
+
+void SystemSampler::sampleCgroup()
+{
+    if (m_cgroupSubscribers.isEmpty() || !hasCgroup())
+        return;
+
+    const qulonglong lastEvents = m_cgroupInfo.highEvents + m_cgroupInfo.maxEvents + m_cgroupInfo.oomEvents;
+    const bool hadSample = m_cgroupInfo.current > 0;
+    if (!m_cgroupSampler->sample(m_cgroupInfo))
+        return;
+
+    // 事件计数增加说明这段时间内被限流或回收
+    const qulonglong events = m_cgroupInfo.highEvents + m_cgroupInfo.maxEvents + m_cgroupInfo.oomEvents;
+    if (hadSample && events > lastEvents)
+        m_lastThrottled.start();
+}
+
+void SystemSampler::recordHistory()
+{
+    if (m_memInfo.memTotal == 0)
+        return;
+
+    // 采样间隔不固定，按经过的秒数补齐或跳过记录
+    int repeat = 1;
+    if (!m_historyClock.isValid()) {
+        m_historyClock.start();
+        m_historyRecorded = 1;
+    } else {
+        const qint64 due = m_historyClock.elapsed() / 1000 + 1;
+        if (due <= m_historyRecorded)
+            return;
+        repeat = int(qMin<qint64>(due - m_historyRecorded, MemoryHistory::SecondCapacity));
+        m_historyRecorded = due;
+    }
+
+    const qreal memPercent = (m_memInfo.memTotal - m_memInfo.memAvailable) * 100. / m_memInfo.memTotal;
+    const qreal swapPercent = m_memInfo.swapTotal > 0 ?
+                (m_memInfo.swapTotal - m_memInfo.swapFree) * 100. / m_memInfo.swapTotal : 0;
+    m_history.append(MemoryHistory::toFixed(memPercent), MemoryHistory::toFixed(swapPercent), repeat);
+}
+
+} // namespace system
+} // namespace core
@@ -0,0 +1,164 @@
+/*
+ * Copyright (C) 2022 UnionTech Technology Co., Ltd.
+ *
+ * Author:     yeshanshan <yeshanshan@uniontech.com>
+ *
+ * Maintainer: yeshanshan <yeshanshan@uniontech.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "mem.h"
+#include "memoryhistory.h"
+#include "pressure.h"
+#include "cgroup.h"
+#include "zram.h"
+
+#include <QObject>
+#include <QBasicTimer>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QSet>
+#include <QScopedPointer>
+
+namespace core {
+namespace system {
+
+/**
+ * @brief 进程内共享的系统采样器，所有组件实例共用一个定时器，每个周期只读取一次，
+ * 没有可见的订阅者时停止采样。
+ * 采样间隔在上下限之间自适应：内存用量快速变化或压力过高时使用下限，
+ * 稳定时逐步退避到上限；能注册 PSI 触发器时压力升高会由内核立即唤醒。
+ * 定时采样的时刻与系统时钟对齐，和宿主的共享定时器在同一次唤醒中完成
+ */
+class SystemSampler : public QObject
+{
+    Q_OBJECT
+public:
+    static SystemSampler *instance();
+
+    // 订阅者销毁后自动取消订阅
+    void subscribe(QObject *subscriber);
+    void unsubscribe(QObject *subscriber);
+    // 只有可见的订阅者才需要采样
+    void setSubscriberActive(QObject *subscriber, const bool active);
+    // 订阅者需要用户会话 cgroup 的数据时才读取
+    void setSubscriberCgroup(QObject *subscriber, const bool enabled);
+    int activeCount() const;
+    bool isRunning() const;
+
+    // 用量有变化但不剧烈时的采样间隔
+    int interval() const;
+    void setInterval(const int msecs);
+    // 自适应调整的上下限，取活跃订阅者中最小的下限和最大的上限
+    int minInterval() const;
+    int maxInterval() const;
+    void setSubscriberIntervalBounds(QObject *subscriber, const int minMsecs, const int maxMsecs);
+    // 当前实际使用的间隔
+    int effectiveInterval() const;
+
+    const MemInfo &memInfo() const;
+    // 按秒记录，停止采样期间没有记录
+    const MemoryHistory &history() const;
+
+    // 内核支持 PSI 时可以读取停顿数据
+    bool hasPressure() const;
+    const PressureInfo &pressure() const;
+    bool isEventDriven() const;
+    bool isPressureHigh() const;
+
+    // 用作交换分区的 zram 设备，压缩的交换数据实际占用的内存
+    const ZramInfo &zramInfo() const;
+
+    // 当前用户会话的 cgroup v2 数据，不支持时 hasCgroup() 返回false
+    bool hasCgroup() const;
+    const CgroupMemInfo &cgroupInfo() const;
+    // 最近一段时间内发生过 memory.high 限流、memory.max 回收或 OOM
+    bool isCgroupThrottled() const;
+
+    // some avg10 达到该百分比时视为压力过高，低于释放值时恢复
+    static constexpr qreal HighPressure = 10.0;
+    static constexpr qreal ReleasePressure = 5.0;
+    // 每秒变化的万分比超过该值时加快采样，低于稳定值时退避
+    static constexpr int FastChange = 100;
+    static constexpr int StableChange = 10;
+    // 限流后保持高亮的时间
+    static constexpr int ThrottleHoldTime = 10000;
+    // 与对齐时刻相差不超过该值时视为同一时刻，和宿主的 TickScheduler 一致
+    static constexpr int MergeTolerance = 20;
+
+Q_SIGNALS:
+    void sampled();
+    void pressureHighChanged(bool high);
+
+protected:
+    virtual void timerEvent(QTimerEvent *event) override;
+
+private:
+    explicit SystemSampler(QObject *parent = nullptr);
+    void updateTimer();
+    void updateIntervalBounds();
+    void restartTimer();
+    void scheduleNext();
+    void armTrigger();
+    void disarmTrigger();
+    void onPressureTriggered();
+    void setPressureHigh(const bool high);
+    void sample();
+    void recordHistory();
+    void adaptInterval();
+    void setEffectiveInterval(const int msecs);
+    void sampleCgroup();
+    void sampleZram();
+
+    QHash<QObject *, bool> m_subscribers;
+    int m_activeCount = 0;
+    int m_interval = 1000;
+    int m_minInterval = 250;
+    int m_maxInterval = 5000;
+    // 订阅者各自设置的 (下限, 上限)
+    QHash<QObject *, QPair<int, int>> m_intervalBounds;
+    int m_effectiveInterval = 1000;
+    int m_lastUsage = -1;
+    QElapsedTimer m_lastSample;
+    QBasicTimer m_timer;
+
+    MemInfoSampler m_memSampler;
+    MemInfo m_memInfo;
+    MemoryHistory m_history;
+    QElapsedTimer m_historyClock;
+    qint64 m_historyRecorded = 0;
+
+    PressureSampler m_pressureSampler;
+    PressureInfo m_pressure;
+    PressureTrigger *m_trigger = nullptr;
+    bool m_triggerUnsupported = false;
+    bool m_pressureHigh = false;
+    QElapsedTimer m_lastTriggered;
+
+    ZramSampler m_zramSampler;
+    ZramInfo m_zramInfo;
+    // 交换分区总量变化时重新查找 zram 设备
+    qulonglong m_zramSwapTotal = ~0ULL;
+
+    QSet<QObject *> m_cgroupSubscribers;
+    QScopedPointer<CgroupSampler> m_cgroupSampler;
+    CgroupMemInfo m_cgroupInfo;
+    QElapsedTimer m_lastThrottled;
+};
+
+} // namespace system
+} // namespace core
@@ -0,0 +1,118 @@
+/*
+ * Copyright (C) 2022 UnionTech Technology Co., Ltd.
+ *
+ * Author:     yeshanshan <yeshanshan@uniontech.com>
+ *
+ * Maintainer: yeshanshan <yeshanshan@uniontech.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "zram.h"
+
+#include <QDebug>
+#include <QFile>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace core {
+namespace system {
+
+ZramSampler::ZramSampler()
+{
+}
+
+ZramSampler::~ZramSampler()
+{
+    closeDevices();
+}
+
+void ZramSampler::discover()
+{
+    closeDevices();
+
+    QFile swaps("/proc/swaps");
+    if (!swaps.open(QIODevice::ReadOnly | QIODevice::Text))
+        return;
+
+    // 首行为表头，之后每行的第一列为设备路径
+    swaps.readLine();
+    while (!swaps.atEnd()) {
+        const QByteArray device = swaps.readLine().simplified().split(' ').value(0);
+        if (!device.startsWith("/dev/zram"))
+            continue;
+
+        const QByteArray path = "/sys/block/" + device.mid(5) + "/mm_stat";
+        const int fd = open(path.constData(), O_RDONLY | O_CLOEXEC);
+        if (fd >= 0)
+            m_fds << fd;
+    }
+    qDebug() << "zram swap devices:" << m_fds.size();
+}
+
+int ZramSampler::deviceCount() const
+{
+    return m_fds.size();
+}
+
+bool ZramSampler::sample(ZramInfo &info)
+{
+    ZramInfo total;
+    for (const auto fd : m_fds) {
+        char buffer[256];
+        const ssize_t size = pread(fd, buffer, sizeof(buffer), 0);
+        if (size <= 0 || !parseMmStat(buffer, int(size), total))
+            continue;
+        ++total.devices;
+    }
+    info = total;
+    return total.devices > 0;
+}
+
+bool ZramSampler::parseMmStat(const char *data, const int size, ZramInfo &info)
+{
+    // orig_data_size compr_data_size mem_used_total ...，单位为字节
+    qulonglong values[3] = {0, 0, 0};
+    const char *p = data;
+    const char *end = data + size;
+    int index = 0;
+    for (; index < 3; ++index) {
+        while (p < end && *p == ' ')
+            ++p;
+        const char *digits = p;
+        while (p < end && *p >= '0' && *p <= '9')
+            values[index] = values[index] * 10 + qulonglong(*p++ - '0');
+        // 后面还有其它字段，截断在数字中间时数据无效
+        if (p == digits || p == end)
+            break;
+    }
+    if (index < 3)
+        return false;
+
+    info.origData += values[0] >> 10;
+    info.comprData += values[1] >> 10;
+    info.memUsed += values[2] >> 10;
+    return true;
+}
+
+void ZramSampler::closeDevices()
+{
+    for (const auto fd : m_fds)
+        close(fd);
+    m_fds.clear();
+}
+
+} // namespace system
+} // namespace core
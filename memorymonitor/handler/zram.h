@@ -0,0 +1,66 @@
+/*
+ * Copyright (C) 2022 UnionTech Technology Co., Ltd.
+ *
+ * Author:     yeshanshan <yeshanshan@uniontech.com>
+ *
+ * Maintainer: yeshanshan <yeshanshan@uniontech.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <QVector>
+
+namespace core {
+namespace system {
+
+// 用作交换分区的 zram 设备的汇总数据，单位为KB
+struct ZramInfo {
+    int devices = 0;
+    qulonglong origData = 0;    // 压缩前的数据量
+    qulonglong comprData = 0;   // 压缩后的数据量
+    qulonglong memUsed = 0;     // 实际占用的内存，包括分配器的开销
+
+    // 压缩率，没有数据时返回0
+    qreal ratio() const { return memUsed > 0 ? qreal(origData) / memUsed : 0; }
+};
+
+/**
+ * @brief 读取 /sys/block/zram<N>/mm_stat，设备列表只在交换分区变化时重新查找，
+ * mm_stat 保持打开，采样时就地解析
+ */
+class ZramSampler
+{
+public:
+    ZramSampler();
+    ~ZramSampler();
+    ZramSampler(const ZramSampler &) = delete;
+    ZramSampler &operator=(const ZramSampler &) = delete;
+
+    // 根据 /proc/swaps 查找用作交换分区的 zram 设备
+    void discover();
+    int deviceCount() const;
+    bool sample(ZramInfo &info);
+
+    static bool parseMmStat(const char *data, const int size, ZramInfo &info);
+
+private:
+    void closeDevices();
+
+    QVector<int> m_fds;
+};
+
+} // namespace system
+} // namespace core
@@ -33,13 +33,23 @@
 #include <QBrush>
 #include <QPaintEvent>
 #include <QFontMetrics>
+#include <QResizeEvent>
+#include <QIcon>
+
+#include <widgetspixmapcache.h>
 
 DWIDGET_USE_NAMESPACE
 
 using namespace Utils;
+WIDGETS_USE_NAMESPACE
+
+static const int TopMargin = 15;
+static const int TrendMargin = 12;
+static const int ProcessIconSize = 16;
 
 MemoryWidget::MemoryWidget(QWidget *parent)
     : QWidget(parent)
+    , m_memoryLabel(tr("Memory"))
 {
     auto *dAppHelper = DApplicationHelper::instance();
     connect(dAppHelper, &DApplicationHelper::themeTypeChanged, this, &MemoryWidget::changeTheme);
@@ -48,14 +58,108 @@ MemoryWidget::MemoryWidget(QWidget *parent)
     changeFont(DApplication::font());
     connect(dynamic_cast<QGuiApplication *>(DApplication::instance()), &DApplication::fontChanged,
             this, &MemoryWidget::changeFont);
+
+    m_recentTrend.setColors(memoryColor, swapColor);
+    m_dailyTrend.setColors(memoryColor, swapColor);
 }
 MemoryWidget::~MemoryWidget() {}
 
 void MemoryWidget::updateMemoryInfo(const QString &memPercent,
                                     const QString &swapPercent)
 {
+    // 显示的数值不变时不重绘
+    if (m_memPercent == memPercent && m_swapPercent == swapPercent)
+        return;
+
     m_memPercent = memPercent;
     m_swapPercent = swapPercent;
+    update(m_summaryRect);
+}
+
+void MemoryWidget::setSessionAccounting(const bool session)
+{
+    const QString &label = session ? tr("Session") : tr("Memory");
+    if (m_memoryLabel == label)
+        return;
+
+    m_memoryLabel = label;
+    updateLayout();
+}
+
+void MemoryWidget::updatePressure(const QString &somePercent, const QString &fullPercent, const bool high)
+{
+    if (m_pressureSome == somePercent && m_pressureFull == fullPercent && m_pressureHigh == high)
+        return;
+
+    // 是否显示压力会改变概要的布局
+    const bool layoutChanged = m_pressureSome.isEmpty() != somePercent.isEmpty();
+    m_pressureSome = somePercent;
+    m_pressureFull = fullPercent;
+    m_pressureHigh = high;
+    if (layoutChanged) {
+        updateLayout();
+        update();
+    } else {
+        update(m_summaryRect);
+    }
+}
+
+void MemoryWidget::updateProcesses(const QVector<core::system::ProcessEntry> &processes)
+{
+    if (m_processes == processes)
+        return;
+
+    m_processes = processes;
+    update(m_processRect);
+}
+
+void MemoryWidget::updateCompression(const qreal ratio, const qulonglong memoryKB)
+{
+    QString compression;
+    if (ratio > 0) {
+        compression = tr("Compressed swap %1x, %2 in RAM")
+                .arg(QString::number(ratio, 'f', 1))
+                .arg(formatUnit(memoryKB, KB, 1));
+    }
+    if (m_compression == compression)
+        return;
+
+    m_compression = compression;
+    update(m_processRect);
+}
+
+void MemoryWidget::updateHistory()
+{
+    if (!m_history)
+        return;
+
+    // 只重绘有新记录的走势
+    const quint64 recent = m_history->appended(core::system::MemoryHistory::Second);
+    if (!m_recentRect.isEmpty() && recent != m_recentAppended) {
+        m_recentAppended = recent;
+        update(m_recentRect);
+    }
+    const quint64 daily = m_history->appended(core::system::MemoryHistory::Minute);
+    if (!m_dailyRect.isEmpty() && daily != m_dailyAppended) {
+        m_dailyAppended = daily;
+        update(m_dailyRect);
+    }
+}
+
+void MemoryWidget::setType(const IWidget::Type type)
+{
+    if (m_type == type)
+        return;
+
+    m_type = type;
+    updateLayout();
+    update();
+}
+
+void MemoryWidget::setHistory(const core::system::MemoryHistory *history)
+{
+    m_history = history;
+    update();
 }
 
 void MemoryWidget::changeTheme(DApplicationHelper::ColorType themeType)
@@ -84,6 +188,7 @@ void MemoryWidget::changeTheme(DApplicationHelper::ColorType themeType)
 #endif
 
     summaryColor = palette.color(DPalette::TextTips);
+    invalidateBackground();
 }
 
 void MemoryWidget::paintEvent(QPaintEvent *e)
@@ -91,18 +196,249 @@ void MemoryWidget::paintEvent(QPaintEvent *e)
     QPainter painter;
     painter.begin(this);
 
-    //裁剪绘制区域
+    // 背景层只在尺寸、主题、字体或缩放比变化时重建
+    const qreal ratio = devicePixelRatioF();
+    if (m_background.isNull() || !qFuzzyCompare(m_background.devicePixelRatio(), ratio))
+        renderBackground();
+
+    const QRect &dirtyRect = e->rect();
+    painter.drawPixmap(QRectF(dirtyRect), m_background,
+                       QRectF(QPointF(dirtyRect.topLeft()) * ratio, QSizeF(dirtyRect.size()) * ratio));
+
+    if (dirtyRect.intersects(m_summaryRect))
+        paintSummary(painter);
+    if (!m_recentRect.isEmpty() && dirtyRect.intersects(m_recentRect))
+        paintTrend(painter, m_recentTrend, m_recentRect);
+    if (!m_dailyRect.isEmpty() && dirtyRect.intersects(m_dailyRect))
+        paintTrend(painter, m_dailyTrend, m_dailyRect);
+    if (!m_processRect.isEmpty() && dirtyRect.intersects(m_processRect))
+        paintProcesses(painter, m_processRect);
+}
+
+void MemoryWidget::resizeEvent(QResizeEvent *event)
+{
+    QWidget::resizeEvent(event);
+    updateLayout();
+}
+
+void MemoryWidget::updateLayout()
+{
+    const QRect contentRect(rect());
+    m_recentRect = QRect();
+    m_dailyRect = QRect();
+    m_processRect = QRect();
+
+    switch (m_type) {
+    case IWidget::Middle:
+        // 左侧为概要，右侧为最近的走势
+        m_summaryRect = QRect(contentRect.topLeft(), QSize(contentRect.height(), contentRect.height()));
+        m_recentRect = QRect(m_summaryRect.right() + 1, contentRect.top(),
+                             contentRect.width() - m_summaryRect.width(), contentRect.height());
+        break;
+    case IWidget::Large: {
+        // 上半部分为概要和两段走势，下半部分为占用内存最多的进程
+        m_summaryRect = QRect(contentRect.topLeft(), contentRect.size() / 2);
+        const QRect trendRect(m_summaryRect.right() + 1, contentRect.top(),
+                              contentRect.width() - m_summaryRect.width(), m_summaryRect.height());
+        m_recentRect = QRect(trendRect.topLeft(), QSize(trendRect.width(), trendRect.height() / 2));
+        m_dailyRect = QRect(trendRect.left(), m_recentRect.bottom() + 1,
+                            trendRect.width(), trendRect.height() - m_recentRect.height());
+        m_processRect = QRect(contentRect.left(), m_summaryRect.bottom() + 1,
+                              contentRect.width(), contentRect.height() - m_summaryRect.height());
+        break;
+    }
+    default:
+        m_summaryRect = contentRect;
+        break;
+    }
+
+    updateSummaryLayout();
+    m_recentTrend.setGeometry(trendPlotRect(m_recentRect).size(), devicePixelRatioF());
+    m_dailyTrend.setGeometry(trendPlotRect(m_dailyRect).size(), devicePixelRatioF());
+    invalidateBackground();
+}
+
+void MemoryWidget::updateSummaryLayout()
+{
+    // 按最长的文本布局，数值变化时标识点和圆环的位置不变
+    const QString maxPercent("100.0");
+    QFontMetrics fmMemTxt(m_memTxtFont);
+    int contentTextWidth = qMax(fmMemTxt.size(Qt::TextSingleLine, QString("%1 (%2%)").arg(m_memoryLabel).arg(maxPercent)).width(),
+                                fmMemTxt.size(Qt::TextSingleLine, QString("%1 (%2%)").arg(tr("SW Memory")).arg(maxPercent)).width());
+    contentTextWidth = qMax(contentTextWidth,
+                            fmMemTxt.size(Qt::TextSingleLine, QString("%1 (%2)").arg(tr("SW Memory")).arg(tr("Unabled"))).width());
+    const bool hasPressure = !m_pressureSome.isEmpty();
+    if (hasPressure) {
+        contentTextWidth = qMax(contentTextWidth,
+                                fmMemTxt.size(Qt::TextSingleLine, QString("%1 (%2% / %3%)").arg(tr("Pressure"))
+                                              .arg(maxPercent).arg(maxPercent)).width());
+    }
+
+    const QRect &contentRect = m_summaryRect;
+    const int sectionSize = 6;
+    const int leftMargin = (contentRect.width() - contentTextWidth) / 2;
+    const int margin = 8;
+    auto indicatorRect = [=](const QRect &txtRect) {
+        return QRectF(txtRect.x() - margin, txtRect.y() + qCeil((txtRect.height() - sectionSize) / 2.),
+                      sectionSize, sectionSize);
+    };
+
+    SummaryLayout &layout = m_summaryLayout;
+    //内存txt
+    layout.memTxtRect = QRect(contentRect.left() + leftMargin, contentRect.top() + TopMargin,
+                              contentTextWidth, fmMemTxt.height());
+    layout.memIndicatorRect = indicatorRect(layout.memTxtRect);
+    layout.swapTxtRect = layout.memTxtRect.translated(0, layout.memTxtRect.height() + margin);
+    layout.swapIndicatorRect = indicatorRect(layout.swapTxtRect);
+    layout.pressureTxtRect = hasPressure ? layout.swapTxtRect.translated(0, layout.swapTxtRect.height() + margin) : QRect();
+    layout.pressureIndicatorRect = hasPressure ? indicatorRect(layout.pressureTxtRect) : QRectF();
+
+    const QRect &lastTxtRect = hasPressure ? layout.pressureTxtRect : layout.swapTxtRect;
+    layout.outsideRingRadius = (contentRect.bottom() - lastTxtRect.bottom() - TopMargin) / 2;
+    layout.insideRingRadius = layout.outsideRingRadius - ringWidth - 1;
+    layout.ringCenter = QPoint(contentRect.center().x(), lastTxtRect.bottom() + margin + layout.outsideRingRadius);
+}
+
+QRect MemoryWidget::trendPlotRect(const QRect &trendRect) const
+{
+    if (trendRect.isEmpty())
+        return QRect();
+
+    // 标题下方为走势图
+    const int captionHeight = QFontMetrics(m_memTxtFont).height();
+    return trendRect.adjusted(TrendMargin, TopMargin + captionHeight + TrendMargin / 2, -TrendMargin, -TrendMargin);
+}
+
+QRect MemoryWidget::captionRect(const QRect &areaRect) const
+{
+    return QRect(areaRect.left() + TrendMargin, areaRect.top() + TopMargin,
+                 areaRect.width() - TrendMargin * 2, QFontMetrics(m_memTxtFont).height());
+}
+
+void MemoryWidget::invalidateBackground()
+{
+    m_background = QPixmap();
+    update();
+}
+
+void MemoryWidget::renderBackground()
+{
+    const qreal ratio = devicePixelRatioF();
+    m_background = QPixmap(size() * ratio);
+    m_background.setDevicePixelRatio(ratio);
+    m_background.fill(Qt::transparent);
+
+    QPainter painter(&m_background);
+    //背景
     QPainterPath path;
     path.addRoundedRect(rect(), 8, 8);
-    painter.setClipPath(path);
-    //背景
-    QRect contentRect(rect());
-    painter.fillRect(contentRect, QBrush(QColor(255, 255, 255,100)));
+    painter.fillPath(path, QBrush(QColor(255, 255, 255,100)));
+
+    // 概要的标识点和圆环轨道
+    const SummaryLayout &layout = m_summaryLayout;
+    QPainterPath section;
+    section.addEllipse(layout.memIndicatorRect);
+    painter.fillPath(section, memoryColor);
+    QPainterPath section2;
+    section2.addEllipse(layout.swapIndicatorRect);
+    painter.fillPath(section2, swapColor);
+
+    drawRing(painter, layout.ringCenter.x(), layout.ringCenter.y(), layout.outsideRingRadius, ringWidth,
+             270, 270, memoryBackgroundColor, memoryBackgroundOpacity);
+    drawRing(painter, layout.ringCenter.x(), layout.ringCenter.y(), layout.insideRingRadius, ringWidth,
+             270, 270, swapBackgroundColor, swapBackgroundOpacity);
+    painter.setOpacity(1);
 
-    int sectionSize = 6;
+    // 走势和进程列表的标题
+    painter.setFont(m_memTxtFont);
+    painter.setPen(QPen(summaryColor));
+    QColor trackColor(memoryBackgroundColor);
+    trackColor.setAlphaF(0.05);
+    if (!m_recentRect.isEmpty()) {
+        const int minutes = qMax(1, m_recentTrend.columns() / 60);
+        painter.drawText(captionRect(m_recentRect), Qt::AlignLeft | Qt::AlignVCenter, tr("Last %1 min").arg(minutes));
+        painter.fillRect(trendPlotRect(m_recentRect), trackColor);
+    }
+    if (!m_dailyRect.isEmpty()) {
+        const qreal hours = m_dailyTrend.columns() / 60.;
+        painter.drawText(captionRect(m_dailyRect), Qt::AlignLeft | Qt::AlignVCenter,
+                         tr("Last %1 h").arg(QString::number(hours, 'f', 1)));
+        painter.fillRect(trendPlotRect(m_dailyRect), trackColor);
+    }
+    if (!m_processRect.isEmpty())
+        painter.drawText(captionRect(m_processRect), Qt::AlignLeft | Qt::AlignVCenter, tr("Top processes"));
+}
+
+void MemoryWidget::paintTrend(QPainter &painter, Sparkline &sparkline, const QRect &trendRect)
+{
+    if (!m_history)
+        return;
+
+    // 屏幕缩放变化时重建缓存
+    const QRect plotRect = trendPlotRect(trendRect);
+    sparkline.setGeometry(plotRect.size(), devicePixelRatioF());
+    sparkline.sync(*m_history);
+    sparkline.paint(painter, plotRect.topLeft());
+}
+
+void MemoryWidget::paintProcesses(QPainter &painter, const QRect &processRect)
+{
+    QFontMetrics fmMemTxt(m_memTxtFont);
+    const int rowHeight = qMax(ProcessIconSize, fmMemTxt.height()) + 6;
+    const QSize iconSize(ProcessIconSize, ProcessIconSize);
+
+    painter.setFont(m_memTxtFont);
+    QRect rowRect = captionRect(processRect);
+    if (!m_compression.isEmpty()) {
+        painter.setPen(QPen(summaryColor));
+        painter.drawText(rowRect, Qt::AlignRight | Qt::AlignVCenter, m_compression);
+    }
+    rowRect.translate(0, rowRect.height() + TrendMargin / 2);
+    rowRect.setHeight(rowHeight);
+    const qreal ratio = devicePixelRatioF();
+    for (const auto &process : m_processes) {
+        if (rowRect.bottom() > processRect.bottom() - TrendMargin)
+            break;
+
+        // 图标名称在进程的生命周期内不变，图片由共享缓存按名称缓存
+        const QString &iconName = process.icon.isEmpty() ? QString("application-x-executable") : process.icon;
+        QPixmap icon;
+        if (iconName.startsWith('/')) {
+            const auto &key = PixmapCache::key(iconName, iconSize, ratio);
+            icon = PixmapCache::instance()->pixmap(key, [iconName, iconSize, ratio]() {
+                QPixmap pixmap = QIcon(iconName).pixmap(iconSize * ratio);
+                pixmap.setDevicePixelRatio(ratio);
+                return pixmap;
+            });
+        } else {
+            icon = PixmapCache::instance()->themeIcon(iconName, iconSize, ratio);
+            if (icon.isNull())
+                icon = PixmapCache::instance()->themeIcon("application-x-executable", iconSize, ratio);
+        }
+        painter.drawPixmap(QRect(QPoint(rowRect.left(), rowRect.top() + (rowRect.height() - ProcessIconSize) / 2),
+                                 iconSize), icon);
+
+        const QString &usage = formatUnit(process.pss > 0 ? process.pss : process.rss, KB, 1);
+        const int usageWidth = fmMemTxt.size(Qt::TextSingleLine, usage).width();
+        painter.setPen(QPen(numberColor));
+        painter.drawText(rowRect, Qt::AlignRight | Qt::AlignVCenter, usage);
+
+        const QRect nameRect(rowRect.left() + ProcessIconSize + TrendMargin / 2, rowRect.top(),
+                             rowRect.width() - ProcessIconSize - TrendMargin - usageWidth, rowRect.height());
+        painter.setPen(QPen(summaryColor));
+        painter.drawText(nameRect, Qt::AlignLeft | Qt::AlignVCenter,
+                         fmMemTxt.elidedText(process.name, Qt::ElideRight, nameRect.width()));
+
+        rowRect.translate(0, rowHeight);
+    }
+}
+
+void MemoryWidget::paintSummary(QPainter &painter)
+{
+    const SummaryLayout &layout = m_summaryLayout;
 
     QString memoryContent = QString("%1 (%2%)")
-                          .arg(tr("Memory"))//Memory
+                          .arg(m_memoryLabel)//Memory
                           .arg(m_memPercent);
 
     QString swapContent;
@@ -117,59 +453,39 @@ void MemoryWidget::paintEvent(QPaintEvent *e)
                               .arg(m_swapPercent);
     }
 
-    QFontMetrics fmMemTxt(m_memTxtFont);
-    const int ContentTextWidth = qMax(fmMemTxt.size(Qt::TextSingleLine, memoryContent).width(),
-                                      fmMemTxt.size(Qt::TextSingleLine, swapContent).width());
-
-    int leftMargin = (contentRect.width() - ContentTextWidth) / 2;
-    int topMargin = 15;
-    int margin = 8;
-    //内存txt
-    QRect memTxtRect(contentRect.left() + leftMargin, contentRect.top() + topMargin,
-                      fmMemTxt.size(Qt::TextSingleLine, memoryContent).width(),
-                      fmMemTxt.height());
-    QRectF memIndicatorRect(memTxtRect.x() - margin, memTxtRect.y() + qCeil((memTxtRect.height() - sectionSize) / 2.),
-                            sectionSize, sectionSize);
-
-
-    QPainterPath section;
-    section.addEllipse(memIndicatorRect);
-    painter.fillPath(section, memoryColor);
-
     painter.setFont(m_memTxtFont);
     painter.setPen(QPen(summaryColor));
-    painter.drawText(memTxtRect, Qt::AlignLeft | Qt::AlignVCenter, memoryContent);
+    painter.drawText(layout.memTxtRect, Qt::AlignLeft | Qt::AlignVCenter, memoryContent);
+    painter.drawText(layout.swapTxtRect, Qt::AlignLeft | Qt::AlignVCenter, swapContent);
 
-    QRect swapTxtRect(memTxtRect.left(), memTxtRect.bottom() + margin,//+ topsize
-                      fmMemTxt.size(Qt::TextSingleLine, swapContent).width(),
-                      fmMemTxt.height());
-    QRectF swapIndicatorRect(swapTxtRect.x() - margin, swapTxtRect.y() + qCeil((swapTxtRect.height() - sectionSize) / 2.),
-                             sectionSize, sectionSize);
+    // 不支持 PSI 时不显示压力
+    if (!layout.pressureTxtRect.isEmpty()) {
+        const QString pressureContent = QString("%1 (%2% / %3%)")
+                .arg(tr("Pressure"))
+                .arg(m_pressureSome)
+                .arg(m_pressureFull);
 
+        // 压力过高时高亮
+        const QColor &pressureTxtColor = m_pressureHigh ? pressureHighColor : summaryColor;
+        QPainterPath section3;
+        section3.addEllipse(layout.pressureIndicatorRect);
+        painter.fillPath(section3, pressureTxtColor);
 
-    QPainterPath section2;
-    section2.addEllipse(swapIndicatorRect);
-    painter.fillPath(section2, swapColor);
+        painter.setPen(QPen(pressureTxtColor));
+        painter.drawText(layout.pressureTxtRect, Qt::AlignLeft | Qt::AlignVCenter, pressureContent);
+    }
 
-    painter.setFont(m_memTxtFont);
-    painter.setPen(QPen(summaryColor));
-    painter.drawText(swapTxtRect, Qt::AlignLeft | Qt::AlignVCenter, swapContent);
-
-    const int outsideRingRadius = (contentRect.bottom() - swapTxtRect.bottom() - topMargin) / 2;
-    const int insideRingRadius = outsideRingRadius - ringWidth - 1;
-    const auto &ringCenter = QPoint(contentRect.center().x(), swapIndicatorRect.bottom() + margin + outsideRingRadius);
-    // Draw memory ring.
-    drawLoadingRing(painter, ringCenter.x(), ringCenter.y(),
-                    outsideRingRadius, ringWidth, 270, 270, memoryForegroundColor,
-                    memoryForegroundOpacity, memoryBackgroundColor, memoryBackgroundOpacity,
-                    m_memPercent.toDouble()/100);
-
-    // Draw swap ring.
-    drawLoadingRing(painter, ringCenter.x(), ringCenter.y(),
-                    insideRingRadius, ringWidth, 270, 270, swapForegroundColor,
-                    swapForegroundOpacity, swapBackgroundColor, swapBackgroundOpacity, m_swapPercent.toDouble()/100);
+    // 圆环的轨道在背景层中，这里只绘制进度
+    const QPoint &ringCenter = layout.ringCenter;
+    drawRing(painter, ringCenter.x(), ringCenter.y(), layout.outsideRingRadius, ringWidth,
+             int(270 * m_memPercent.toDouble() / 100), 270,
+             m_pressureHigh ? pressureHighColor : memoryForegroundColor, memoryForegroundOpacity);
+    drawRing(painter, ringCenter.x(), ringCenter.y(), layout.insideRingRadius, ringWidth,
+             int(270 * m_swapPercent.toDouble() / 100), 270, swapForegroundColor, swapForegroundOpacity);
+    painter.setOpacity(1);
 
     // Draw percent text.
+    const int insideRingRadius = layout.insideRingRadius;
     painter.setFont(m_memPercentFont);
     painter.setPen(QPen(numberColor));
     painter.drawText(QRect(ringCenter.x() - insideRingRadius,
@@ -185,4 +501,5 @@ void MemoryWidget::changeFont(const QFont &font)
     m_memTxtFont.setFamily("SourceHanSansSC");
     m_memTxtFont.setWeight(QFont::ExtraLight);
     m_memTxtFont.setPointSizeF(m_memTxtFont.pointSizeF()-2 );
+    updateLayout();
 }
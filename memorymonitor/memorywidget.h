@@ -21,6 +21,10 @@
 
 #pragma once
 
+#include "sparkline.h"
+#include "handler/processscanner.h"
+
+#include <widgetsinterface.h>
 #include <DApplicationHelper>
 #include <QWidget>
 DWIDGET_USE_NAMESPACE
@@ -35,13 +39,50 @@ public:
 
     void updateMemoryInfo(const QString &memPercent,
                           const QString &swapPercent);
+    // 按用户会话 cgroup 统计时内存一栏显示为会话
+    void setSessionAccounting(const bool session);
+    // 内存压力的停顿百分比，为空时表示不支持 PSI
+    void updatePressure(const QString &somePercent, const QString &fullPercent, const bool high);
+    // 大尺寸下显示占用内存最多的进程
+    void updateProcesses(const QVector<core::system::ProcessEntry> &processes);
+    // 大尺寸下显示压缩交换的压缩率和占用的内存，ratio为0时不显示
+    void updateCompression(const qreal ratio, const qulonglong memoryKB);
+    // 历史有新记录时重绘对应的走势
+    void updateHistory();
+    // 中、大尺寸下绘制历史走势
+    void setType(const WIDGETS_NAMESPACE::IWidget::Type type);
+    void setHistory(const core::system::MemoryHistory *history);
 
 protected:
     virtual void paintEvent(QPaintEvent *event) override;
+    virtual void resizeEvent(QResizeEvent *event) override;
 
 private:
     void changeTheme(DApplicationHelper::ColorType themeType);
     void changeFont(const QFont &font);
+    void updateLayout();
+    void updateSummaryLayout();
+    QRect trendPlotRect(const QRect &trendRect) const;
+    QRect captionRect(const QRect &areaRect) const;
+    void invalidateBackground();
+    // 背景、标识点、圆环轨道和标题等静态内容绘制到缓存中
+    void renderBackground();
+    void paintSummary(QPainter &painter);
+    void paintTrend(QPainter &painter, Sparkline &sparkline, const QRect &trendRect);
+    void paintProcesses(QPainter &painter, const QRect &processRect);
+
+    // 概要部分的布局，只在尺寸或字体变化时计算
+    struct SummaryLayout {
+        QRect memTxtRect;
+        QRectF memIndicatorRect;
+        QRect swapTxtRect;
+        QRectF swapIndicatorRect;
+        QRect pressureTxtRect;
+        QRectF pressureIndicatorRect;
+        QPoint ringCenter;
+        int outsideRingRadius = 0;
+        int insideRingRadius = 0;
+    };
 
 private:
     QColor summaryColor;
@@ -54,6 +95,7 @@ private:
     QColor swapBackgroundColor;
     QColor swapColor {"#FEDF19"};
     QColor swapForegroundColor {"#FEDF19"};
+    QColor pressureHighColor {"#FF5736"};
 
     qreal memoryBackgroundOpacity = 0.1;
     qreal memoryForegroundOpacity = 1.0;
@@ -63,7 +105,28 @@ private:
 
     QFont m_memPercentFont;
 
+    QString m_memoryLabel;
     QString m_memPercent;
     //交换内存
     QString m_swapPercent;
+    QString m_pressureSome;
+    QString m_pressureFull;
+    bool m_pressureHigh = false;
+
+    WIDGETS_NAMESPACE::IWidget::Type m_type = WIDGETS_NAMESPACE::IWidget::Small;
+    const core::system::MemoryHistory *m_history = nullptr;
+    // 最近的秒级走势和一天内的分钟级走势
+    Sparkline m_recentTrend {core::system::MemoryHistory::Second};
+    Sparkline m_dailyTrend {core::system::MemoryHistory::Minute};
+    QRect m_summaryRect;
+    QRect m_recentRect;
+    QRect m_dailyRect;
+    QRect m_processRect;
+    QVector<core::system::ProcessEntry> m_processes;
+    QString m_compression;
+
+    SummaryLayout m_summaryLayout;
+    QPixmap m_background;
+    quint64 m_recentAppended = 0;
+    quint64 m_dailyAppended = 0;
 };
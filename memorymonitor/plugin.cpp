@@ -21,13 +21,14 @@
 
 #include "plugin.h"
 #include "common/helper.hpp"
+#include "common/dbushelper.hpp"
 #include "accessible/accessible.h"
 
 #include "common/utils.h"
-#include "handler/mem.h"
+#include "handler/systemsampler.h"
+#include "handler/processscanner.h"
 
 #include <QAccessible>
-#include <QDBusInterface>
 
 QString MemoryMonitorWidgetPlugin::title() const
 {
@@ -46,21 +47,52 @@ IWidget *MemoryMonitorWidgetPlugin::createWidget()
 
 void MemoryMonitorWidget::updateMemory()
 {
-    core::system::MemInfo info;
-    info.readMemInfo();
+    auto sampler = core::system::SystemSampler::instance();
+    const auto &info = sampler->memInfo();
+    if (info.memTotal == 0)
+        return;
 
     using namespace Utils;
-    const auto &memPercent = QString::number((info.memTotal() - info.memAvailable()) * 1. / info.memTotal() * 100, 'f', 1);
+    auto memPercent = QString::number((info.memTotal - info.memAvailable) * 1. / info.memTotal * 100, 'f', 1);
 
-    const auto &swapUsage = formatUnit((info.swapTotal() - info.swapFree()) << 10, B, 1);
-    auto swapPercent = QString::number((info.swapTotal() - info.swapFree()) * 1. / info.swapTotal() * 100, 'f', 1);
+    const auto &swapUsage = formatUnit((info.swapTotal - info.swapFree) << 10, B, 1);
+    auto swapPercent = QString::number((info.swapTotal - info.swapFree) * 1. / info.swapTotal * 100, 'f', 1);
     // This process is the same as `deepin-system-monitor-plugin`
     if (swapUsage.split(" ").size() != 2)
         swapPercent = QString();
 
+    bool sessionAccounting = false;
+    auto pressure = sampler->pressure();
+    bool pressureHigh = sampler->isPressureHigh();
+    if (m_cgroupMode && sampler->hasCgroup()) {
+        // 会话用量相对于会话上限，未设置上限时相对于物理内存
+        const auto &cgroup = sampler->cgroupInfo();
+        const qulonglong limit = cgroup.limit() > 0 ? qMin(cgroup.limit(), info.memTotal) : info.memTotal;
+        memPercent = QString::number(qMin(100., cgroup.current * 100. / limit), 'f', 1);
+        sessionAccounting = true;
+        pressure = cgroup.pressure;
+        pressureHigh = sampler->isCgroupThrottled() ||
+                pressure.some.avg10 >= core::system::SystemSampler::HighPressure;
+    }
+
+    QString pressureSome;
+    QString pressureFull;
+    if (sampler->hasPressure()) {
+        pressureSome = QString::number(pressure.some.avg10, 'f', 1);
+        pressureFull = QString::number(pressure.full.avg10, 'f', 1);
+    }
+
     if (m_view) {
+        m_view->setSessionAccounting(sessionAccounting);
         m_view->updateMemoryInfo(memPercent, swapPercent);
-        m_view->update();
+        m_view->updatePressure(pressureSome, pressureFull, pressureHigh);
+        m_view->updateHistory();
+
+        // zram 和 zswap 中压缩的交换数据实际占用的内存
+        const auto &zram = sampler->zramInfo();
+        const qulonglong compressedMemory = zram.memUsed + info.zswap;
+        const qulonglong originalData = zram.origData + info.zswapped;
+        m_view->updateCompression(compressedMemory > 0 ? qreal(originalData) / compressedMemory : 0, compressedMemory);
     }
 }
 
@@ -70,44 +102,92 @@ bool MemoryMonitorWidget::initialize(const QStringList &arguments) {
     if (!hasLoaded)
         hasLoaded = BuildinWidgetsHelper::instance()->loadTranslator("dde-widgets-memorymonitor_");
 
-    m_view = new MemoryWidget();
-    m_timer.reset(new QBasicTimer());
-    m_view->installEventFilter(this);
+    createView();
+    // 所有实例共用一份采样数据，可见时才参与采样
+    auto sampler = core::system::SystemSampler::instance();
+    sampler->subscribe(this);
+    connect(sampler, &core::system::SystemSampler::sampled, this, &MemoryMonitorWidget::updateMemory);
+    connect(core::system::ProcessScanner::instance(), &core::system::ProcessScanner::updated,
+            this, &MemoryMonitorWidget::updateProcesses);
 
     return true;
 }
 
-void MemoryMonitorWidget::delayInitialize()
+void MemoryMonitorWidget::updateProcesses()
 {
-    // enable accessible
-    QAccessible::installFactory(memoryMonitorAccessibleFactory);
+    if (!m_view)
+        return;
+
+    m_view->updateProcesses(core::system::ProcessScanner::instance()->topProcesses());
 }
 
-void MemoryMonitorWidget::typeChanged(const IWidget::Type type)
+void MemoryMonitorWidget::updateProcessScanner()
 {
-    Q_UNUSED(type)
-    m_view->setFixedSize(handler()->size());
+    // 只有可见的大尺寸组件需要扫描进程
+    const bool active = m_active && m_type == IWidget::Large;
+    // 按 "processMetric" 配置选择排序依据，"pss" 更准确但读取开销更大
+    const bool pss = active && handler()->value("processMetric", "rss").toString() == "pss";
+    core::system::ProcessScanner::instance()->setSubscriberActive(this, active,
+        pss ? core::system::ProcessScanWorker::Pss : core::system::ProcessScanWorker::Rss);
+    if (active)
+        updateProcesses();
 }
 
-void MemoryMonitorWidget::timerEvent(QTimerEvent *event)
+void MemoryMonitorWidget::createView()
 {
-    if (event->timerId() == m_timer->timerId())
+    m_view = new MemoryWidget();
+    m_view->setHistory(&core::system::SystemSampler::instance()->history());
+    m_view->installEventFilter(this);
+}
+
+void MemoryMonitorWidget::visibilityChanged(const IWidget::VisibilityState state, const bool isPreview)
+{
+    Q_UNUSED(isPreview);
+    const bool active = state == IWidget::Visible || state == IWidget::Editing;
+    auto sampler = core::system::SystemSampler::instance();
+    if (active) {
+        // "accounting" 为 "cgroup" 时显示当前用户会话的用量和上限
+        m_cgroupMode = handler()->value("accounting", "system").toString() == "cgroup";
+        sampler->setSubscriberCgroup(this, m_cgroupMode);
+        // 自适应采样间隔的上下限，单位毫秒
+        sampler->setSubscriberIntervalBounds(this, handler()->value("minInterval", 250).toInt(),
+                                             handler()->value("maxInterval", 5000).toInt());
+    }
+    sampler->setSubscriberActive(this, active);
+    if (active)
         updateMemory();
 
-    return QObject::timerEvent(event);
+    m_active = active;
+    updateProcessScanner();
+}
+
+bool MemoryMonitorWidget::hibernate()
+{
+    // 显示内容都来自实时采样，没有需要保存的状态
+    delete m_view.data();
+    m_isPressed = false;
+    return true;
 }
 
-void MemoryMonitorWidget::showWidgets()
+void MemoryMonitorWidget::wakeup()
 {
+    createView();
     updateMemory();
+    updateProcesses();
+}
 
-    const int Interval = 1000;
-    m_timer->start(Interval, this);
+void MemoryMonitorWidget::delayInitialize()
+{
+    // enable accessible
+    QAccessible::installFactory(memoryMonitorAccessibleFactory);
 }
 
-void MemoryMonitorWidget::hideWidgets()
+void MemoryMonitorWidget::typeChanged(const IWidget::Type type)
 {
-    m_timer->stop();
+    m_type = type;
+    m_view->setType(type);
+    m_view->setFixedSize(handler()->size());
+    updateProcessScanner();
 }
 
 bool MemoryMonitorWidget::eventFilter(QObject *watched, QEvent *event)
@@ -137,15 +217,14 @@ bool MemoryMonitorWidget::eventFilter(QObject *watched, QEvent *event)
 
 void MemoryMonitorWidget::showSystemMonitorDetail()
 {
-    QDBusInterface interface("com.deepin.SystemMonitorMain", "/com/deepin/SystemMonitorMain",
-                              "com.deepin.SystemMonitorMain");
-     if (!interface.isValid()) {
-         qWarning() << "Get com.deepin.SystemMonitorMain interface error." << interface.lastError().message();
-         return;
-     }
-     qDebug() << "showSystemMonitorDetail()";
-     const QString MsgCodeName("MSG_PROCESS");
-     interface.call("slotJumpProcessWidget", MsgCodeName);
+    qDebug() << "showSystemMonitorDetail()";
+    const QString MsgCodeName("MSG_PROCESS");
+    const DBusHelper systemMonitor("com.deepin.SystemMonitorMain", "/com/deepin/SystemMonitorMain",
+                                   "com.deepin.SystemMonitorMain");
+    systemMonitor.asyncCall("slotJumpProcessWidget", {MsgCodeName}, this, [](const QDBusMessage &reply) {
+        if (reply.type() == QDBusMessage::ErrorMessage)
+            qWarning() << "Call com.deepin.SystemMonitorMain error." << reply.errorMessage();
+    });
 }
 
 QIcon MemoryMonitorWidgetPlugin::logo() const
@@ -25,27 +25,28 @@
 #include "memorywidget.h"
 
 #include <QObject>
-#include <QBasicTimer>
 #include <QPointer>
 
 WIDGETS_USE_NAMESPACE
 
-class MemoryMonitorWidget : public QObject, public IWidget {
+class MemoryMonitorWidget : public QObject, public IWidget, public IWidgetExtension {
     Q_OBJECT
 public:
     virtual QWidget *view() override {
         return m_view.data();
     }
-    virtual ~MemoryMonitorWidget() override {
-        if (m_timer)
-            m_timer->stop();
-    }
+    virtual ~MemoryMonitorWidget() override { }
 private:
+    void createView();
     void updateMemory();
+    void updateProcesses();
+    void updateProcessScanner();
 
     QPointer<MemoryWidget> m_view;
-    QScopedPointer<QBasicTimer> m_timer;
     bool m_isPressed = false;
+    bool m_active = false;
+    bool m_cgroupMode = false;
+    IWidget::Type m_type = IWidget::Small;
 
 public:
     virtual bool initialize(const QStringList &arguments) override;
@@ -54,11 +55,11 @@ public:
 
     virtual void typeChanged(const IWidget::Type type) override;
 
-    virtual void showWidgets() override;
-    virtual void hideWidgets() override;
+    virtual void visibilityChanged(const IWidget::VisibilityState state, const bool isPreview) override;
+
+    virtual bool hibernate() override;
 
-protected:
-    virtual void timerEvent(QTimerEvent *event) override;
+    virtual void wakeup() override;
 
 private Q_SLOTS:
     void showSystemMonitorDetail();
@@ -78,7 +79,7 @@ public:
     QString title() const override;
     virtual QString description() const override;
     virtual IWidget *createWidget() override;
-    virtual QVector<IWidget::Type> supportTypes() const { return {IWidget::Small};}
+    virtual QVector<IWidget::Type> supportTypes() const { return {IWidget::Small, IWidget::Middle, IWidget::Large};}
     virtual IWidgetPlugin::Type type() const override { return IWidgetPlugin::Normal; }
 
     virtual QIcon logo() const override;
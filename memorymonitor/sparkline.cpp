@@ -0,0 +1,158 @@
+/*
+ * Copyright (C) 2022 UnionTech Technology Co., Ltd.
+ *
+ * Author:     yeshanshan <yeshanshan@uniontech.com>
+ *
+ * Maintainer: yeshanshan <yeshanshan@uniontech.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "sparkline.h"
+
+#include <QPainter>
+
+using core::system::MemoryHistory;
+
+Sparkline::Sparkline(const MemoryHistory::Resolution resolution)
+    : m_resolution(resolution)
+{
+}
+
+void Sparkline::setColors(const QColor &memoryColor, const QColor &swapColor)
+{
+    if (m_memoryColor == memoryColor && m_swapColor == swapColor)
+        return;
+
+    m_memoryColor = memoryColor;
+    m_swapColor = swapColor;
+    m_valid = false;
+}
+
+void Sparkline::setGeometry(const QSize &size, const qreal devicePixelRatio)
+{
+    if (m_size == size && qFuzzyCompare(m_devicePixelRatio, devicePixelRatio))
+        return;
+
+    m_size = size;
+    m_devicePixelRatio = devicePixelRatio;
+    m_valid = false;
+}
+
+QSize Sparkline::size() const
+{
+    return m_size;
+}
+
+int Sparkline::columns() const
+{
+    return qMax(0, m_size.width());
+}
+
+void Sparkline::sync(const MemoryHistory &history)
+{
+    if (m_size.isEmpty())
+        return;
+
+    const quint64 appended = history.appended(m_resolution);
+    if (!m_valid || appended < m_synced || appended - m_synced > static_cast<quint64>(columns())) {
+        rebuild(history);
+        return;
+    }
+    if (appended == m_synced)
+        return;
+
+    QPainter painter(&m_image);
+    const int count = history.count(m_resolution);
+    for (int i = count - static_cast<int>(appended - m_synced); i < count; ++i)
+        appendColumn(painter, history.at(m_resolution, i));
+    m_synced = appended;
+}
+
+void Sparkline::paint(QPainter &painter, const QPoint &topLeft) const
+{
+    if (!m_valid || m_filled <= 0)
+        return;
+
+    // 最新的记录靠右，图像中 m_column 之前是较新的部分
+    const qreal dpr = m_devicePixelRatio;
+    const int width = columns();
+    int x = topLeft.x() + width - m_filled;
+    if (m_filled == width && m_column > 0) {
+        const int tail = width - m_column;
+        painter.drawImage(QRectF(x, topLeft.y(), tail, m_size.height()), m_image,
+                          QRectF(m_column * dpr, 0, tail * dpr, m_image.height()));
+        x += tail;
+    }
+    const int head = m_filled == width ? m_column : m_filled;
+    if (head > 0) {
+        painter.drawImage(QRectF(x, topLeft.y(), head, m_size.height()), m_image,
+                          QRectF(0, 0, head * dpr, m_image.height()));
+    }
+}
+
+void Sparkline::rebuild(const MemoryHistory &history)
+{
+    const QSize pixelSize = m_size * m_devicePixelRatio;
+    if (m_image.size() != pixelSize)
+        m_image = QImage(pixelSize, QImage::Format_ARGB32_Premultiplied);
+    m_image.setDevicePixelRatio(m_devicePixelRatio);
+    m_image.fill(Qt::transparent);
+    m_column = 0;
+    m_filled = 0;
+    m_valid = true;
+
+    const int count = history.count(m_resolution);
+    const int first = qMax(0, count - columns());
+    m_last = history.at(m_resolution, first);
+    QPainter painter(&m_image);
+    for (int i = first; i < count; ++i)
+        appendColumn(painter, history.at(m_resolution, i));
+    m_synced = history.appended(m_resolution);
+}
+
+void Sparkline::appendColumn(QPainter &painter, const MemoryHistory::Sample &sample)
+{
+    const int x = m_column;
+    const int height = m_size.height();
+
+    painter.setCompositionMode(QPainter::CompositionMode_Source);
+    painter.fillRect(x, 0, 1, height, Qt::transparent);
+    painter.setCompositionMode(QPainter::CompositionMode_SourceOver);
+
+    // 内存使用率绘制为面积，交换分区只绘制折线
+    QColor area(m_memoryColor);
+    area.setAlphaF(0.2);
+    const int memoryY = valueToY(sample.memory);
+    painter.fillRect(x, memoryY, 1, height - memoryY, area);
+
+    // 与上一列的值相连，保证曲线连续
+    auto drawSegment = [&painter, x, this](const quint16 from, const quint16 to, const QColor &color) {
+        const int y1 = valueToY(from);
+        const int y2 = valueToY(to);
+        painter.fillRect(x, qMin(y1, y2), 1, qAbs(y1 - y2) + 1, color);
+    };
+    drawSegment(m_last.swap, sample.swap, m_swapColor);
+    drawSegment(m_last.memory, sample.memory, m_memoryColor);
+
+    m_last = sample;
+    m_column = (m_column + 1) % columns();
+    m_filled = qMin(m_filled + 1, columns());
+}
+
+int Sparkline::valueToY(const quint16 value) const
+{
+    const int height = m_size.height() - 1;
+    return height - value * height / MemoryHistory::FullScale;
+}
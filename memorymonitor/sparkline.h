@@ -0,0 +1,67 @@
+/*
+ * Copyright (C) 2022 UnionTech Technology Co., Ltd.
+ *
+ * Author:     yeshanshan <yeshanshan@uniontech.com>
+ *
+ * Maintainer: yeshanshan <yeshanshan@uniontech.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "handler/memoryhistory.h"
+
+#include <QColor>
+#include <QImage>
+
+class QPainter;
+
+/**
+ * @brief 内存和交换分区使用率的走势图，缓存为一张环形图像，
+ * 每条新记录只绘制一列，不重绘整条曲线
+ */
+class Sparkline
+{
+public:
+    explicit Sparkline(const core::system::MemoryHistory::Resolution resolution);
+
+    void setColors(const QColor &memoryColor, const QColor &swapColor);
+    void setGeometry(const QSize &size, const qreal devicePixelRatio);
+    QSize size() const;
+    // 能显示的记录数
+    int columns() const;
+
+    // 追加历史中新增的记录，新增过多或尺寸变化时才整体重建
+    void sync(const core::system::MemoryHistory &history);
+    void paint(QPainter &painter, const QPoint &topLeft) const;
+
+private:
+    void rebuild(const core::system::MemoryHistory &history);
+    void appendColumn(QPainter &painter, const core::system::MemoryHistory::Sample &sample);
+    int valueToY(const quint16 value) const;
+
+    core::system::MemoryHistory::Resolution m_resolution;
+    QColor m_memoryColor;
+    QColor m_swapColor;
+    QSize m_size;
+    qreal m_devicePixelRatio = 1.0;
+
+    QImage m_image;
+    bool m_valid = false;
+    int m_column = 0;   // 下一列的写入位置
+    int m_filled = 0;
+    quint64 m_synced = 0;
+    core::system::MemoryHistory::Sample m_last;
+};
@@ -1,11 +1,26 @@
 set(HEADERS
     "memorywidget.h"
+    "sparkline.h"
     "common/utils.h"
+    "common/flatpakresolver.h"
     "handler/mem.h"
-    "handler/mem_p.h"
+    "handler/memoryhistory.h"
+    "handler/pressure.h"
+    "handler/cgroup.h"
+    "handler/zram.h"
+    "handler/processscanner.h"
+    "handler/systemsampler.h"
 )
 set(SOURCES
     "memorywidget.cpp"
+    "sparkline.cpp"
     "common/utils.cpp"
+    "common/flatpakresolver.cpp"
     "handler/mem.cpp"
+    "handler/memoryhistory.cpp"
+    "handler/pressure.cpp"
+    "handler/cgroup.cpp"
+    "handler/zram.cpp"
+    "handler/processscanner.cpp"
+    "handler/systemsampler.cpp"
 )
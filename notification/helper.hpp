@@ -23,7 +23,8 @@
 
 #include <QDebug>
 #include <QCoreApplication>
-#include <QDBusInterface>
+#include <QDBusConnection>
+#include <QDBusMessage>
 
 namespace notify {
 class Helper {
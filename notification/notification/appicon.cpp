@@ -29,6 +29,10 @@
 
 #include "appicon.h"
 
+#include <widgetspixmapcache.h>
+
+WIDGETS_USE_NAMESPACE
+
 AppIcon::AppIcon(QWidget *parent) :
     QLabel(parent)
 {
@@ -36,6 +40,18 @@ AppIcon::AppIcon(QWidget *parent) :
     this->setAlignment(Qt::AlignCenter);
 }
 
+static QPixmap scaledPixmap(QPixmap pixmap, const QSize &size, const qreal pixelRatio)
+{
+    if (!pixmap.isNull()) {
+        pixmap = pixmap.scaled(size * pixelRatio,
+                               Qt::KeepAspectRatioByExpanding,
+                               Qt::SmoothTransformation);
+
+        pixmap.setDevicePixelRatio(pixelRatio);
+    }
+    return pixmap;
+}
+
 void AppIcon::setIcon(const QString &iconPath, const QString &fallback)
 {
     const qreal pixelRatio = qApp->primaryScreen()->devicePixelRatio();
@@ -53,16 +69,15 @@ void AppIcon::setIcon(const QString &iconPath, const QString &fallback)
     if (pixmap.isNull()) {
         const QUrl url(iconPath);
         QString iconUrl = url.isLocalFile() ? url.toLocalFile() : url.url();
-        const QIcon &icon = QIcon::fromTheme(iconUrl, QIcon::fromTheme(fallback, QIcon::fromTheme("application-x-desktop")));
-        pixmap = icon.pixmap(width() * pixelRatio, height() * pixelRatio);
+        const QSize size(width(), height());
+        // 同一个应用的通知共用缩放后的图标
+        const auto &key = PixmapCache::key(iconUrl, size, pixelRatio, QIcon::themeName() + "/" + fallback);
+        setPixmap(PixmapCache::instance()->pixmap(key, [iconUrl, fallback, size, pixelRatio]() {
+            const QIcon &icon = QIcon::fromTheme(iconUrl, QIcon::fromTheme(fallback, QIcon::fromTheme("application-x-desktop")));
+            return scaledPixmap(icon.pixmap(size * pixelRatio), size, pixelRatio);
+        }));
+        return;
     }
 
-    if (!pixmap.isNull()) {
-        pixmap = pixmap.scaled(width() * pixelRatio, height() * pixelRatio,
-                               Qt::KeepAspectRatioByExpanding,
-                               Qt::SmoothTransformation);
-
-        pixmap.setDevicePixelRatio(pixelRatio);
-    }
-    setPixmap(pixmap);
+    setPixmap(scaledPixmap(pixmap, QSize(width(), height()), pixelRatio));
 }
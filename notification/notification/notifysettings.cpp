@@ -24,8 +24,6 @@
 #include "constants.h"
 
 #include <QStringList>
-#include <QDBusInterface>
-#include <QDBusPendingCall>
 #include <QDBusPendingReply>
 
 static const QString DDENotifyDBusServer = "org.deepin.dde.Notification1";
@@ -34,50 +32,65 @@ static const QString DDENotifyDBusPath = "/org/deepin/dde/Notification1";
 
 NotifySettingsObserver::NotifySettingsObserver(QObject *parent)
     : AbstractNotifySetting(parent)
+    , m_notifyObserver(DDENotifyDBusServer, DDENotifyDBusPath, DDENotifyDBusInterface)
 {
 }
 
 void NotifySettingsObserver::setAppSetting(const QString &id, const NotifySettingsObserver::AppConfigurationItem &item, const QVariant &var)
 {
     qDebug() << "setAppSetting()" << id << item << var;
-    notifyObserver()->call("SetAppInfo", id, static_cast<uint>(item), QVariant::fromValue(QDBusVariant(var)));
+    notifyObserver().asyncCall("SetAppInfo", {id, static_cast<uint>(item), QVariant::fromValue(QDBusVariant(var))});
 }
 
 QVariant NotifySettingsObserver::getAppSetting(const QString &id, const NotifySettingsObserver::AppConfigurationItem &item)
 {
-    QDBusPendingCall call = notifyObserver()->asyncCall("GetAppInfo", id, static_cast<uint>(item));
-    call.waitForFinished();
-    QDBusPendingReply<QVariant> reply(call);
-    const QVariant &data = reply.value();
-    qDebug() << "getAppSetting()" << id << item << data;
-    return data;
+    const QString &key = cacheKey(id, item);
+    auto iter = m_appSettings.constFind(key);
+    if (iter != m_appSettings.constEnd())
+        return iter.value();
+
+    if (m_pendingRequests.contains(key))
+        return QVariant();
+
+    m_pendingRequests.insert(key);
+    notifyObserver().asyncCall<QDBusVariant>("GetAppInfo", {id, static_cast<uint>(item)}, this,
+                                             [this, id, item, key] (const QDBusPendingReply<QDBusVariant> &reply) {
+        m_pendingRequests.remove(key);
+        if (reply.isError()) {
+            qWarning() << "getAppSetting() GetAppInfo error:" << id << item << reply.error();
+            // 缓存默认值，避免服务不可用时反复请求
+            m_appSettings[key] = QVariant();
+            return;
+        }
+        const QVariant &data = reply.value().variant();
+        qDebug() << "getAppSetting()" << id << item << data;
+        m_appSettings[key] = data;
+        Q_EMIT appSettingChanged(id, item, data);
+    });
+    return QVariant();
 }
 
 void NotifySettingsObserver::onReceivedAppInfoChanged(const QString &id, uint item, QDBusVariant var)
 {
     qDebug() << "onReceivedAppInfoChanged()" << id << item << var.variant();
+    m_appSettings[cacheKey(id, item)] = var.variant();
     Q_EMIT appSettingChanged(id, item, var.variant());
 }
 
-QDBusInterface *NotifySettingsObserver::notifyObserver()
+const DBusHelper &NotifySettingsObserver::notifyObserver()
 {
-    if (!m_notifyObserver) {
-        m_notifyObserver.reset(new QDBusInterface(DDENotifyDBusServer, DDENotifyDBusPath, DDENotifyDBusInterface));
-
-        if (!m_notifyObserver->isValid()) {
-            qWarning() << "notifyObserver() NotifyInterface is invalid, and can't send operator.";
-        }
+    if (!m_isConnected) {
+        m_isConnected = true;
 
-        // TODO it' can be removed when service is registered.
-        notifyObserver()->setTimeout(10);
-
-        auto connection = QDBusConnection::sessionBus();
-        bool valid = connection.connect(DDENotifyDBusServer, DDENotifyDBusPath, DDENotifyDBusInterface,
-                           "AppInfoChanged", this, SLOT(onReceivedAppInfoChanged(const QString &, uint, QDBusVariant)));
+        bool valid = m_notifyObserver.connect("AppInfoChanged", this, SLOT(onReceivedAppInfoChanged(const QString &, uint, QDBusVariant)));
         if (!valid) {
-            qWarning() << "notifyObserver() NotifyConnection is invalid, and can't receive AppInfoChanged signal."
-                       << connection.lastError();
+            qWarning() << "notifyObserver() NotifyConnection is invalid, and can't receive AppInfoChanged signal.";
         }
     }
-    return m_notifyObserver.get();
+    return m_notifyObserver;
+}
+
+QString NotifySettingsObserver::cacheKey(const QString &id, const uint item)
+{
+    return QString("%1/%2").arg(id).arg(item);
 }
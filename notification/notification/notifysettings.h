@@ -26,8 +26,11 @@
 #include "launcher_interface.h"
 #include "types/launcheriteminfo.h"
 #include "types/launcheriteminfolist.h"
+#include "common/dbushelper.hpp"
 
 #include <QObject>
+#include <QHash>
+#include <QSet>
 
 class QGSettings;
 class QTimer;
@@ -95,9 +98,14 @@ private Q_SLOTS:
     void onReceivedAppInfoChanged(const QString &id, uint item, QDBusVariant var);
 
 private:
-    QDBusInterface *notifyObserver();
+    const DBusHelper &notifyObserver();
+    static QString cacheKey(const QString &id, const uint item);
 
-    QScopedPointer<QDBusInterface> m_notifyObserver;
+    DBusHelper m_notifyObserver;
+    bool m_isConnected = false;
+    // 应用配置缓存，key为 id/item，未命中时异步获取并通过 appSettingChanged 通知
+    QHash<QString, QVariant> m_appSettings;
+    QSet<QString> m_pendingRequests;
 };
 
 #endif // NOTIFYSETTINGS_H
@@ -28,7 +28,6 @@
 #include <QJsonArray>
 #include <QJsonObject>
 #include <QMapIterator>
-#include <QDBusInterface>
 #include <QDBusPendingCall>
 #include <QDBusPendingReply>
 
@@ -40,54 +39,53 @@ static const QString DDENotifyDBusPath = "/org/deepin/dde/Notification1";
 
 PersistenceObserver::PersistenceObserver(QObject *parent)
     : AbstractPersistence(parent)
+    , m_notifyObserver(DDENotifyDBusServer, DDENotifyDBusPath, DDENotifyDBusInterface)
 {
 }
 
 void PersistenceObserver::removeOne(const QString &id)
 {
     qDebug() << "removeOne() RemoveRecord id:" << id;
-    notifyObserver()->asyncCall("RemoveRecord", id);
+    notifyObserver().asyncCall("RemoveRecord", {id});
 }
 
 void PersistenceObserver::removeAll()
 {
     qDebug() << "removeAll() ClearRecords";
-    notifyObserver()->asyncCall("ClearRecords");
+    notifyObserver().asyncCall("ClearRecords");
 }
 
-QList<EntityPtr> PersistenceObserver::getAllNotify()
+void PersistenceObserver::fetchAllNotify()
 {
-    qDebug() << "getAllNotify() GetAllRecords";
-    QDBusPendingCall call = notifyObserver()->asyncCall("GetAllRecords");
-    call.waitForFinished();
-    QDBusPendingReply<QString> reply(call);
-    const QString &data = reply.value();
-
-    QList<EntityPtr> result;
-    QJsonArray notifys = QJsonDocument::fromJson(data.toLocal8Bit()).array();
-    foreach (auto notify, notifys) {
-        QJsonObject obj = notify.toObject();
-        auto entity = json2Entity(obj);
-        if (!entity) {
-            qWarning() << "getAllNotify() entity is invalid" << obj;
-            continue;
+    qDebug() << "fetchAllNotify() GetAllRecords";
+    notifyObserver().asyncCall<QString>("GetAllRecords", {}, this, [this] (const QDBusPendingReply<QString> &reply) {
+        if (reply.isError()) {
+            qWarning() << "fetchAllNotify() GetAllRecords error:" << reply.error();
+            return;
+        }
+        const QString &data = reply.value();
+
+        QList<EntityPtr> result;
+        QJsonArray notifys = QJsonDocument::fromJson(data.toLocal8Bit()).array();
+        foreach (auto notify, notifys) {
+            QJsonObject obj = notify.toObject();
+            auto entity = json2Entity(obj);
+            if (!entity) {
+                qWarning() << "fetchAllNotify() entity is invalid" << obj;
+                continue;
+            }
+            result << entity;
         }
-        result << entity;
-    }
 
-    return result;
+        Q_EMIT AllNotifyFetched(result);
+    });
 }
 
 void PersistenceObserver::onReceivedRecord(const QString &id)
 {
     qDebug() << "onReceivedRecord() RecordAdded id" << id;
     // TODO multiple RecordAdded requests can be merged into one.
-    QDBusPendingCall call = notifyObserver()->asyncCall("GetRecordById", id);
-
-    QDBusPendingCallWatcher *watcher = new QDBusPendingCallWatcher(call, this);
-    QObject::connect(watcher, &QDBusPendingCallWatcher::finished,
-                     this, [this] (QDBusPendingCallWatcher *call) {
-        QDBusPendingReply<QString> reply = *call;
+    notifyObserver().asyncCall<QString>("GetRecordById", {id}, this, [this] (const QDBusPendingReply<QString> &reply) {
         if (reply.isError()) {
             qWarning() << "onReceivedRecord() GetRecordById error:" << reply.error();
         } else {
@@ -96,7 +94,6 @@ void PersistenceObserver::onReceivedRecord(const QString &id)
                 emit RecordAdded(entity);
             }
         }
-        call->deleteLater();
     });
 }
 
@@ -143,22 +140,16 @@ EntityPtr PersistenceObserver::json2Entity(const QJsonObject &obj)
     return notification;
 }
 
-QDBusInterface * PersistenceObserver::notifyObserver()
+const DBusHelper &PersistenceObserver::notifyObserver()
 {
-    if (!m_notifyObserver) {
-        m_notifyObserver.reset(new QDBusInterface(DDENotifyDBusServer, DDENotifyDBusPath, DDENotifyDBusInterface));
-
-        if (!m_notifyObserver->isValid()) {
-            qWarning() << "notifyObserver() NotifyInterface is invalid, and can't send operator.";
-        }
+    if (!m_isConnected) {
+        m_isConnected = true;
 
-        auto connection = QDBusConnection::sessionBus();
-        bool valid = connection.connect(DDENotifyDBusServer, DDENotifyDBusPath, DDENotifyDBusInterface,
-                           "RecordAdded", this, SLOT(onReceivedRecord(const QString &)));
+        bool valid = m_notifyObserver.connect("RecordAdded", this, SLOT(onReceivedRecord(const QString &)));
         if (!valid) {
             qWarning() << "notifyObserver() NotifyConnection is invalid, and can't receive RecordAdded signal.";
         }
 
     }
-    return m_notifyObserver.get();
+    return m_notifyObserver;
 }
@@ -23,10 +23,10 @@
 #ifndef PERSISTENCE_H
 #define PERSISTENCE_H
 
-#include <QDBusInterface>
 #include <QObject>
 
 #include "constants.h"
+#include "common/dbushelper.hpp"
 
 #define ACTION_SEGMENT ("|")
 #define HINT_SEGMENT ("|")
@@ -49,7 +49,7 @@ public:
     virtual void removeApp(const QString &app_name) = 0;
     virtual void removeAll() = 0;
 
-    virtual QList<EntityPtr> getAllNotify() = 0;
+    virtual void fetchAllNotify() = 0;                   //异步获取所有通知，结果由AllNotifyFetched返回
     virtual QString getAll() = 0;
     virtual QString getById(const QString &id) = 0;
 
@@ -58,6 +58,7 @@ public:
 
 signals:
     void RecordAdded(EntityPtr entity);
+    void AllNotifyFetched(QList<EntityPtr> entities);
 };
 
 class PersistenceObserver : public AbstractPersistence
@@ -72,7 +73,7 @@ public:
     void removeApp(const QString &appName) override { Q_UNUSED(appName); Q_UNREACHABLE(); }
     void removeAll() override;                           //从数据库删除所有通知
 
-    QList<EntityPtr> getAllNotify() override;            //获取所有通知
+    void fetchAllNotify() override;                      //获取所有通知
     QString getAll() override { Q_UNREACHABLE(); }
     QString getById(const QString &id) override { Q_UNUSED(id); Q_UNREACHABLE(); }
 
@@ -89,10 +90,11 @@ private:
     EntityPtr json2Entity(const QString &data);
     EntityPtr json2Entity(const QJsonObject &obj);
 
-    QDBusInterface *notifyObserver();
+    const DBusHelper &notifyObserver();
 
 private:
-    QScopedPointer<QDBusInterface> m_notifyObserver;
+    DBusHelper m_notifyObserver;
+    bool m_isConnected = false;
 };
 
 #endif // PERSISTENCE_H
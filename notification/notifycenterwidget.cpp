@@ -33,7 +33,6 @@
 
 #include <QDesktopWidget>
 #include <QBoxLayout>
-#include <QDBusInterface>
 #include <QPalette>
 #include <QDebug>
 #include <QTimer>
@@ -60,6 +59,11 @@ NotifyCenterWidget::NotifyCenterWidget(AbstractPersistence *database, QWidget *p
     CompositeChanged();
 }
 
+void NotifyCenterWidget::refreshItemTime()
+{
+    Q_EMIT m_notifyWidget->view()->refreshItemTime();
+}
+
 void NotifyCenterWidget::initUI()
 {
     m_notifyWidget->setAccessibleName("NotifyWidget");
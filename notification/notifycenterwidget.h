@@ -58,6 +58,7 @@ class NotifyCenterWidget : public DBlurEffectWidget
     Q_OBJECT
 public:
     explicit NotifyCenterWidget(AbstractPersistence *database, QWidget* parent = nullptr);
+    void refreshItemTime();     //刷新消息的相对时间
 
 private:
     void initUI();              //初始化主界面
@@ -33,6 +33,8 @@
 #include "notification/iconbutton.h"
 #include "notification/button.h"
 
+#include <widgetsinstrumentation.h>
+
 #include <QParallelAnimationGroup>
 #include <QSequentialAnimationGroup>
 #include <QPropertyAnimation>
@@ -46,14 +48,21 @@
 #include <QTimer>
 #include <QBasicTimer>
 
-#define RefreshTime 900
+WIDGETS_USE_NAMESPACE
+// 记录动画期间的帧时间，动画组以DeleteWhenStopped启动，销毁时即结束。
+static void traceAnimation(QAbstractAnimation *animation, const QString &name)
+{
+    Instrumentation::instance()->beginFrameTrace(name);
+    QObject::connect(animation, &QObject::destroyed, [name]() {
+        Instrumentation::instance()->endFrameTrace(name);
+    });
+}
 
 // TODO: need to setFixedHeight Mini Height, other it's default contentSize is 150 px.
 static const int ListViewMinHeight = 1;
 NotifyListView::NotifyListView(QWidget *parent)
     : DListView(parent)
     , m_scrollAni(new QPropertyAnimation(verticalScrollBar(), "value" ,this))
-    , m_refreshTimer(new QTimer(this))
     , m_layoutRequestTimer(new QBasicTimer())
 {
 //    setSizeAdjustPolicy(QAbstractScrollArea::AdjustToContents);
@@ -62,10 +71,7 @@ NotifyListView::NotifyListView(QWidget *parent)
     m_scrollAni->setEasingCurve(QEasingCurve::OutQuint);
     m_scrollAni->setDuration(800);
 
-    m_refreshTimer->setInterval(RefreshTime);
-
     setVerticalScrollMode(QAbstractItemView::ScrollPerPixel);
-    connect(m_refreshTimer, &QTimer::timeout, this, &NotifyListView::refreshItemTime);
     connect(m_scrollAni, &QPropertyAnimation::valueChanged, this, &NotifyListView::handleScrollValueChanged);
     connect(m_scrollAni, &QPropertyAnimation::finished, this, &NotifyListView::handleScrollFinished);
 
@@ -119,6 +125,7 @@ void NotifyListView::createRemoveAnimation(BubbleItem *item)
         removeAniGroup->addAnimation(topMoveAni);
     }
 
+    traceAnimation(removeAniGroup, "notification-remove");
     removeAniGroup->start(QPropertyAnimation::DeleteWhenStopped);
     m_aniState = true;
 }
@@ -184,6 +191,7 @@ void NotifyListView::createExpandAnimation(int idx, const ListItemPtr appItem)
         ani->setDuration(ExpandAnimationTime * needCount);
         downMoveAniGroup->addAnimation(ani);
     }
+    traceAnimation(insertAniGroup, "notification-expand");
     insertAniGroup->start(QPropertyAnimation::DeleteWhenStopped);
     downMoveAniGroup->start(QPropertyAnimation::DeleteWhenStopped);
     m_aniState = true;
@@ -274,6 +282,7 @@ void NotifyListView::createAddedAnimation(EntityPtr entity, const ListItemPtr ap
         removeAni->setDuration(AnimationTime);
         addedAniGroup->addAnimation(removeAni);
     }
+    traceAnimation(addedAniGroup, "notification-add");
     addedAniGroup->start(QPropertyAnimation::DeleteWhenStopped);
     m_aniState = true;
 }
@@ -298,20 +307,12 @@ void NotifyListView::mousePressEvent(QMouseEvent *event)
     return QListView::mousePressEvent(event);
 }
 
-void NotifyListView::showEvent(QShowEvent *event)
-{
-    m_refreshTimer->start();
-
-    return QListView::showEvent(event);
-}
-
 void NotifyListView::hideEvent(QHideEvent *event)
 {
     m_currentIndex = 0;
     m_currentElement = nullptr;
     m_prevElement = nullptr;
     verticalScrollBar()->setValue(0);
-    m_refreshTimer->stop();
 
     return QListView::hideEvent(event);
 }
@@ -55,7 +55,6 @@ public:
 
 protected:
     void mousePressEvent(QMouseEvent *event) override;
-    void showEvent(QShowEvent *event) override;
     void hideEvent(QHideEvent *event) override;
     void wheelEvent(QWheelEvent *event) override;
     virtual bool event(QEvent *event) override;
@@ -81,7 +80,6 @@ private:
     QPropertyAnimation *m_scrollAni;
     QPointer<QWidget> m_prevElement = nullptr;
     QPointer<QWidget> m_currentElement = nullptr;
-    QTimer *m_refreshTimer = nullptr;
     QBasicTimer *m_layoutRequestTimer = nullptr;
 };
 
@@ -28,6 +28,7 @@
 #include <QDebug>
 #include <QDateTime>
 #include <QTimer>
+#include <QSet>
 
 NotifyModel::NotifyModel(QObject *parent, AbstractPersistence *database, NotifyListView *view)
     : QAbstractListModel(parent)
@@ -317,8 +318,27 @@ void NotifyModel::refreshAppTopping()
 void NotifyModel::initData()
 {
     if (m_database == nullptr)  return;
-    QList<EntityPtr> notifications = m_database->getAllNotify();
+    connect(m_database, &AbstractPersistence::AllNotifyFetched, this, &NotifyModel::onAllNotifyFetched);
+    m_database->fetchAllNotify();
+}
+
+void NotifyModel::onAllNotifyFetched(QList<EntityPtr> notifications)
+{
+    // 异步查询期间收到的新通知可能已经在模型或缓存中，按 id 去重
+    QSet<uint> knownIds;
+    for (const auto &item : qAsConst(m_notifications)) {
+        for (const auto &entity : item->data())
+            knownIds.insert(entity->id());
+    }
+    for (const auto &entity : qAsConst(m_cacheList))
+        knownIds.insert(entity->id());
 
+    auto it = std::remove_if(notifications.begin(), notifications.end(), [&knownIds](const EntityPtr &ptr) {
+        return knownIds.contains(ptr->id());
+    });
+    notifications.erase(it, notifications.end());
+
+    beginResetModel();
     std::sort(notifications.begin(), notifications.end(), [](const EntityPtr& ptr1,const EntityPtr& ptr2) {
         return ptr1->ctime().toLongLong() > ptr2->ctime().toLongLong();
     });
@@ -330,10 +350,11 @@ void NotifyModel::initData()
             m_database->removeOne(QString::number(notify->id()));
         }
     }
-    qDebug() << "initData(): Notification count:" << notifications.count()
+    qDebug() << "onAllNotifyFetched(): Notification count:" << notifications.count()
              << ", App's count:" << m_notifications.count();
 
     sortNotifications();
+    endResetModel();
 }
 
 void NotifyModel::initConnect()
@@ -353,14 +374,14 @@ void NotifyModel::onReceivedAppInfoChanged(const QString &id, uint item, QVarian
     if (item == AbstractNotifySetting::SHOWNOTIFICATIONTOP) {
         for (int i = 0; i < m_notifications.size(); i++) {
             if (m_notifications[i]->appName() == id) {
+                changed = !m_notifications[i]->hasAppTopping() || m_notifications[i]->isAppTopping() != var.toBool();
                 m_notifications[i]->setAppTopping(var.toBool());
-                changed = true;
                 break;
             }
         }
     }
     if (changed)
-        sortNotifications();
+        refreshAppTopping();
 }
 
 void NotifyModel::addAppData(EntityPtr entity)
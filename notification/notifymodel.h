@@ -207,6 +207,7 @@ Q_SIGNALS:
 
 private Q_SLOTS:
     void onReceivedAppInfoChanged(const QString &id, uint item, QVariant var);
+    void onAllNotifyFetched(QList<EntityPtr> notifications);
 
 private:
     void initData();                                    // 初始化数据
@@ -52,6 +52,11 @@ bool NotificationWidget::initialize(const QStringList &arguments) {
     m_persistence = new PersistenceObserver();
     m_view.reset(new NotifyCenterWidget(m_persistence));
     m_view->setFixedWidth(handler()->size().width());
+
+    auto view = m_view.data();
+    handler()->subscribeTick(WidgetHandler::PerSecond, view, [view]() {
+        view->refreshItemTime();
+    });
     return true;
 }
 
@@ -0,0 +1,83 @@
+/*
+ * Copyright (C) 2022 UnionTech Technology Co., Ltd.
+ *
+ * Author:     yeshanshan <yeshanshan@uniontech.com>
+ *
+ * Maintainer: yeshanshan <yeshanshan@uniontech.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include "cellspatialindex.h"
+WIDGETS_FRAME_USE_NAMESPACE
+
+// two rows of flow layout, the second row is taller than a bucket.
+static const QVector<QRect> Cells {
+    QRect(0, 0, 170, 170),
+    QRect(190, 0, 170, 170),
+    QRect(0, 190, 360, 360),
+    QRect(0, 570, 170, 170)
+};
+
+TEST(ut_CellSpatialIndex, indexAt)
+{
+    CellSpatialIndex index;
+    ASSERT_FALSE(index.isValid());
+    ASSERT_EQ(index.indexAt(QPoint(10, 10)), -1);
+
+    index.rebuild(Cells);
+    ASSERT_TRUE(index.isValid());
+    ASSERT_EQ(index.count(), Cells.size());
+    ASSERT_EQ(index.indexAt(QPoint(10, 10)), 0);
+    ASSERT_EQ(index.indexAt(QPoint(200, 169)), 1);
+    ASSERT_EQ(index.indexAt(QPoint(180, 10)), -1);
+    ASSERT_EQ(index.indexAt(QPoint(300, 400)), 2);
+    ASSERT_EQ(index.indexAt(QPoint(10, 739)), 3);
+    ASSERT_EQ(index.indexAt(QPoint(10, 800)), -1);
+    ASSERT_EQ(index.indexAt(QPoint(10, -10)), -1);
+
+    index.invalidate();
+    ASSERT_FALSE(index.isValid());
+}
+
+TEST(ut_CellSpatialIndex, maxIntersected)
+{
+    CellSpatialIndex index;
+    index.rebuild(Cells);
+
+    ASSERT_EQ(index.maxIntersected(QRect(100, 100, 170, 170)), 2);
+    ASSERT_EQ(index.maxIntersected(QRect(100, 0, 170, 100)), 1);
+    ASSERT_EQ(index.maxIntersected(QRect(150, 0, 60, 100)), 0);
+    ASSERT_EQ(index.maxIntersected(QRect(200, 580, 100, 100)), -1);
+
+    // it's same as linear scan.
+    for (int y = -50; y < 800; y += 37) {
+        for (int x = -50; x < 400; x += 41) {
+            const QRect rect(x, y, 170, 170);
+            int expected = -1;
+            qlonglong maxArea = 0;
+            for (int i = 0; i < Cells.size(); i++) {
+                const auto &intersected = Cells[i].intersected(rect);
+                const qlonglong area = qlonglong(intersected.width()) * intersected.height();
+                if (!intersected.isEmpty() && area > maxArea) {
+                    maxArea = area;
+                    expected = i;
+                }
+            }
+            ASSERT_EQ(index.maxIntersected(rect), expected);
+        }
+    }
+}
@@ -0,0 +1,96 @@
+/*
+ * Copyright (C) 2022 UnionTech Technology Co., Ltd.
+ *
+ * Author:     yeshanshan <yeshanshan@uniontech.com>
+ *
+ * Maintainer: yeshanshan <yeshanshan@uniontech.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include "framerecorder.h"
+#include <widgetsinstrumentation.h>
+#include <QJsonDocument>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QSignalSpy>
+WIDGETS_FRAME_USE_NAMESPACE
+WIDGETS_USE_NAMESPACE
+
+TEST(ut_FrameRecorder, percentile)
+{
+    ASSERT_EQ(FrameRecorder::percentile({}, 50), 0);
+
+    const QVector<qreal> values{16, 17, 15, 50, 16, 16, 17, 16, 33, 16};
+    ASSERT_EQ(FrameRecorder::percentile(values, 50), 16);
+    ASSERT_EQ(FrameRecorder::percentile(values, 90), 33);
+    ASSERT_EQ(FrameRecorder::percentile(values, 100), 50);
+}
+
+TEST(ut_FrameRecorder, droppedFrames)
+{
+    const qreal interval = 1000.0 / 60;
+    ASSERT_EQ(FrameRecorder::droppedFrames({16.6, 17, 16}, interval), 0);
+    ASSERT_EQ(FrameRecorder::droppedFrames({16.6, 33.4, 50}, interval), 3);
+    ASSERT_EQ(FrameRecorder::droppedFrames({16.6, 33.4}, 0), 0);
+}
+
+TEST(ut_FrameRecorder, trace)
+{
+    FrameRecorder recorder;
+    auto instrumentation = Instrumentation::instance();
+    QSignalSpy spy(instrumentation, &Instrumentation::frameTraceEnded);
+
+    instrumentation->beginFrameTrace("disabled");
+    instrumentation->endFrameTrace("disabled");
+    ASSERT_EQ(spy.count(), 0);
+
+    recorder.setEnabled(true);
+    instrumentation->beginFrameTrace("nested");
+    instrumentation->beginFrameTrace("nested");
+    instrumentation->endFrameTrace("nested");
+    ASSERT_EQ(spy.count(), 0);
+    instrumentation->endFrameTrace("nested");
+    ASSERT_EQ(spy.count(), 1);
+
+    const auto &report = QJsonDocument::fromJson(recorder.report().toUtf8()).object();
+    ASSERT_TRUE(report["enabled"].toBool());
+    ASSERT_EQ(report["sessions"].toArray().size(), 1);
+    ASSERT_EQ(report["sessions"].toArray().first().toObject()["name"].toString(), QString("nested"));
+
+    recorder.setEnabled(false);
+    ASSERT_FALSE(instrumentation->isEnabled());
+}
+
+TEST(ut_FrameRecorder, markedFrames)
+{
+    FrameRecorder recorder;
+    auto instrumentation = Instrumentation::instance();
+    recorder.setEnabled(true);
+
+    instrumentation->markFrame("slide");
+    instrumentation->beginFrameTrace("slide");
+    for (int i = 0; i < 4; ++i)
+        instrumentation->markFrame("slide");
+    instrumentation->endFrameTrace("slide");
+
+    const auto &sessions = QJsonDocument::fromJson(recorder.report().toUtf8()).object()["sessions"].toArray();
+    ASSERT_EQ(sessions.size(), 1);
+    // 第一帧只作为起点
+    ASSERT_EQ(sessions.first().toObject()["frames"].toInt(), 3);
+
+    recorder.setEnabled(false);
+}
@@ -0,0 +1,159 @@
+/*
+ * Copyright (C) 2022 UnionTech Technology Co., Ltd.
+ *
+ * Author:     yeshanshan <yeshanshan@uniontech.com>
+ *
+ * Maintainer: yeshanshan <yeshanshan@uniontech.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include "memoryaccountant.h"
+#include "allocationcounter.h"
+#include <QSignalSpy>
+#include <QJsonArray>
+#include <QScopedPointer>
+#include <QThread>
+#include <QTimer>
+
+#include <memory>
+#include <cstring>
+WIDGETS_FRAME_USE_NAMESPACE
+
+static const qint64 AllocSize = 4 * 1024 * 1024;
+
+TEST(ut_MemoryAccountant, disabled)
+{
+    MemoryAccountant accountant;
+    ASSERT_FALSE(accountant.isEnabled());
+    accountant.end();
+    ASSERT_EQ(accountant.liveBytes("plugin"), 0);
+}
+
+TEST(ut_MemoryAccountant, scope)
+{
+    if (!AllocationCounter::isSupported())
+        return;
+
+    auto accountant = MemoryAccountant::instance();
+    accountant->setEnabled(true);
+    accountant->clear();
+
+    std::unique_ptr<char[]> leaked;
+    {
+        MemoryScope scope("plugin");
+        leaked.reset(new char[AllocSize]);
+        memset(leaked.get(), 1, AllocSize);
+    }
+    ASSERT_GE(accountant->liveBytes("plugin"), AllocSize);
+    ASSERT_GE(accountant->peakBytes("plugin"), AllocSize);
+
+    {
+        MemoryScope scope("plugin");
+        leaked.reset();
+    }
+    ASSERT_LT(accountant->liveBytes("plugin"), AllocSize);
+    ASSERT_GE(accountant->peakBytes("plugin"), AllocSize);
+
+    accountant->setEnabled(false);
+    accountant->clear();
+}
+
+TEST(ut_MemoryAccountant, nestedScope)
+{
+    if (!AllocationCounter::isSupported())
+        return;
+
+    MemoryAccountant accountant;
+    accountant.setEnabled(true);
+
+    std::unique_ptr<char[]> outer;
+    std::unique_ptr<char[]> inner;
+    accountant.begin("outer");
+    outer.reset(new char[AllocSize]);
+    accountant.begin("inner");
+    inner.reset(new char[AllocSize]);
+    accountant.end();
+    accountant.end();
+
+    ASSERT_GE(accountant.liveBytes("inner"), AllocSize);
+    ASSERT_GE(accountant.liveBytes("outer"), AllocSize);
+    ASSERT_LT(accountant.liveBytes("outer"), AllocSize * 2);
+}
+
+TEST(ut_MemoryAccountant, budget)
+{
+    if (!AllocationCounter::isSupported())
+        return;
+
+    MemoryAccountant accountant;
+    accountant.setEnabled(true);
+    accountant.setBudget("plugin", 1024);
+    ASSERT_EQ(accountant.budget("plugin"), 1024);
+
+    QSignalSpy spy(&accountant, &MemoryAccountant::budgetExceeded);
+    std::unique_ptr<char[]> leaked;
+    accountant.begin("plugin");
+    leaked.reset(new char[AllocSize]);
+    accountant.end();
+    ASSERT_EQ(spy.count(), 1);
+
+    // 仍超出预算时不再重复告警
+    accountant.begin("plugin");
+    std::unique_ptr<char[]> more(new char[AllocSize]);
+    accountant.end();
+    ASSERT_EQ(spy.count(), 1);
+
+    const auto &plugins = accountant.report({})["plugins"].toArray();
+    ASSERT_EQ(plugins.count(), 1);
+    ASSERT_EQ(plugins.first().toObject()["pluginId"].toString(), QString("plugin"));
+    ASSERT_TRUE(plugins.first().toObject()["overBudget"].toBool());
+}
+
+TEST(ut_MemoryAccountant, otherThread)
+{
+    if (!AllocationCounter::isSupported())
+        return;
+
+    MemoryAccountant accountant;
+    accountant.setEnabled(true);
+
+    // 区间打开期间其他线程的分配不记到插件上
+    std::unique_ptr<char[]> leaked;
+    accountant.begin("plugin");
+    QScopedPointer<QThread> thread(QThread::create([&leaked]() {
+        leaked.reset(new char[AllocSize]);
+    }));
+    thread->start();
+    thread->wait();
+    accountant.end();
+
+    ASSERT_TRUE(leaked);
+    ASSERT_LT(accountant.liveBytes("plugin"), AllocSize);
+}
+
+TEST(ut_MemoryAccountant, ownerOf)
+{
+    MemoryAccountant accountant;
+    QObject root;
+    QTimer *timer = new QTimer(&root);
+    QObject other;
+    accountant.tagObject(&root, "plugin");
+
+    ASSERT_EQ(accountant.ownerOf(&root), QString("plugin"));
+    ASSERT_EQ(accountant.ownerOf(timer), QString("plugin"));
+    ASSERT_TRUE(accountant.ownerOf(&other).isEmpty());
+}
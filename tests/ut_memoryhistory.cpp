@@ -0,0 +1,155 @@
+/*
+ * Copyright (C) 2022 UnionTech Technology Co., Ltd.
+ *
+ * Author:     yeshanshan <yeshanshan@uniontech.com>
+ *
+ * Maintainer: yeshanshan <yeshanshan@uniontech.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include "handler/memoryhistory.h"
+#include "sparkline.h"
+
+#include <QImage>
+#include <QPainter>
+#include <QScopedPointer>
+
+using core::system::MemoryHistory;
+
+TEST(ut_MemoryHistory, toFixed)
+{
+    struct Case {
+        qreal percent;
+        quint16 fixed;
+    };
+    const Case cases[] {
+        {0, 0},
+        {-1, 0},
+        {qQNaN(), 0},
+        {12.34, 1234},
+        {50, 5000},
+        {100, MemoryHistory::FullScale},
+        {150, MemoryHistory::FullScale},
+    };
+    for (const auto &item : cases) {
+        SCOPED_TRACE(item.percent);
+        ASSERT_EQ(MemoryHistory::toFixed(item.percent), item.fixed);
+    }
+    ASSERT_DOUBLE_EQ(MemoryHistory::toPercent(5000), 50.0);
+}
+
+TEST(ut_MemoryHistory, ringWrap)
+{
+    // 容量较大，避免放在栈上
+    QScopedPointer<MemoryHistory> history(new MemoryHistory());
+    ASSERT_EQ(history->count(MemoryHistory::Second), 0);
+    ASSERT_EQ(history->at(MemoryHistory::Second, 0).memory, 0);
+
+    const int capacity = history->capacity(MemoryHistory::Second);
+    const int total = capacity + 10;
+    for (int i = 0; i < total; ++i)
+        history->append(quint16(i), quint16(total - i));
+
+    // 写满后覆盖最早的记录，下标0始终是最早的一条
+    ASSERT_EQ(history->count(MemoryHistory::Second), capacity);
+    ASSERT_EQ(history->appended(MemoryHistory::Second), quint64(total));
+    ASSERT_EQ(history->at(MemoryHistory::Second, 0).memory, 10);
+    ASSERT_EQ(history->at(MemoryHistory::Second, capacity - 1).memory, total - 1);
+    ASSERT_EQ(history->last(MemoryHistory::Second).swap, 1);
+    ASSERT_EQ(history->at(MemoryHistory::Second, capacity).memory, 0);
+    ASSERT_EQ(history->at(MemoryHistory::Second, -1).memory, 0);
+
+    history->clear();
+    ASSERT_EQ(history->count(MemoryHistory::Second), 0);
+    ASSERT_EQ(history->count(MemoryHistory::Minute), 0);
+    ASSERT_EQ(history->appended(MemoryHistory::Second), 0u);
+}
+
+TEST(ut_MemoryHistory, downsample)
+{
+    QScopedPointer<MemoryHistory> history(new MemoryHistory());
+    const int factor = MemoryHistory::DownsampleFactor;
+
+    history->append(1000, 100, factor - 1);
+    ASSERT_EQ(history->count(MemoryHistory::Second), factor - 1);
+    ASSERT_EQ(history->count(MemoryHistory::Minute), 0);
+
+    // 凑满一组后取平均
+    history->append(1000 + factor, 100);
+    ASSERT_EQ(history->count(MemoryHistory::Minute), 1);
+    ASSERT_EQ(history->last(MemoryHistory::Minute).memory, 1001);
+    ASSERT_EQ(history->last(MemoryHistory::Minute).swap, 100);
+
+    history->append(3000, 300, factor);
+    ASSERT_EQ(history->count(MemoryHistory::Minute), 2);
+    ASSERT_EQ(history->last(MemoryHistory::Minute).memory, 3000);
+
+    // 分钟级的环形缓冲区同样会回绕
+    const int capacity = history->capacity(MemoryHistory::Minute);
+    history->append(5000, 500, factor * capacity);
+    ASSERT_EQ(history->count(MemoryHistory::Minute), capacity);
+    ASSERT_EQ(history->appended(MemoryHistory::Minute), quint64(capacity + 2));
+    ASSERT_EQ(history->at(MemoryHistory::Minute, 0).memory, 5000);
+}
+
+static QImage render(const Sparkline &sparkline)
+{
+    QImage image(sparkline.size(), QImage::Format_ARGB32_Premultiplied);
+    image.fill(Qt::transparent);
+    QPainter painter(&image);
+    sparkline.paint(painter, QPoint(0, 0));
+    return image;
+}
+
+TEST(ut_Sparkline, incrementalSync)
+{
+    QScopedPointer<MemoryHistory> history(new MemoryHistory());
+    const QSize size(16, 10);
+
+    Sparkline incremental(MemoryHistory::Second);
+    incremental.setColors(Qt::red, Qt::blue);
+    incremental.setGeometry(size, 1.0);
+    ASSERT_EQ(incremental.columns(), size.width());
+
+    // 没有记录时不绘制
+    incremental.sync(*history);
+    QImage empty(size, QImage::Format_ARGB32_Premultiplied);
+    empty.fill(Qt::transparent);
+    ASSERT_EQ(render(incremental), empty);
+
+    // 记录数超过列数，图像中的写入位置会回绕
+    for (int i = 0; i < 40; ++i) {
+        history->append(MemoryHistory::toFixed(i * 2.5), MemoryHistory::toFixed(100 - i * 2.5));
+        incremental.sync(*history);
+    }
+    history->append(MemoryHistory::FullScale, 0);
+    incremental.sync(*history);
+
+    Sparkline rebuilt(MemoryHistory::Second);
+    rebuilt.setColors(Qt::red, Qt::blue);
+    rebuilt.setGeometry(size, 1.0);
+    rebuilt.sync(*history);
+
+    const QImage &incrementalImage = render(incremental);
+    const QImage &rebuiltImage = render(rebuilt);
+    // 重建时最左一列没有前一条记录可以相连，不参与比较
+    const QRect compared(1, 0, size.width() - 1, size.height());
+    ASSERT_EQ(incrementalImage.copy(compared), rebuiltImage.copy(compared));
+
+    // 最新的记录在最右侧，满载时曲线到达顶部
+    ASSERT_EQ(incrementalImage.pixelColor(size.width() - 1, 0), QColor(Qt::red));
+}
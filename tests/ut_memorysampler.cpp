@@ -0,0 +1,266 @@
+/*
+ * Copyright (C) 2022 UnionTech Technology Co., Ltd.
+ *
+ * Author:     yeshanshan <yeshanshan@uniontech.com>
+ *
+ * Maintainer: yeshanshan <yeshanshan@uniontech.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include "handler/mem.h"
+#include "handler/pressure.h"
+#include "handler/cgroup.h"
+#include "handler/zram.h"
+
+#include <QByteArray>
+#include <QVector>
+
+using namespace core::system;
+
+// 实际采集的 /proc/meminfo 前部
+static const QByteArray MemInfoSample(
+        "MemTotal:       16303332 kB\n"
+        "MemFree:         1853084 kB\n"
+        "MemAvailable:    9273500 kB\n"
+        "Buffers:          582924 kB\n"
+        "Cached:          7145236 kB\n"
+        "SwapCached:        12288 kB\n"
+        "Active:          5881432 kB\n"
+        "Inactive:        6891164 kB\n"
+        "Active(anon):    2410220 kB\n"
+        "Inactive(anon):   935416 kB\n"
+        "SwapTotal:       2097148 kB\n"
+        "SwapFree:        2040316 kB\n"
+        "Zswap:             10240 kB\n"
+        "Zswapped:          40960 kB\n"
+        "Dirty:               620 kB\n"
+        "Mapped:           973328 kB\n"
+        "Shmem:            812340 kB\n"
+        "Slab:             702744 kB\n");
+
+static const QByteArray PressureSample(
+        "some avg10=1.53 avg60=0.87 avg300=0.25 total=1234567\n"
+        "full avg10=0.50 avg60=0.20 avg300=0.05 total=456789\n");
+
+static const QByteArray CgroupStatSample(
+        "anon 536870912\n"
+        "file 1073741824\n"
+        "kernel 67108864\n"
+        "kernel_stack 1048576\n"
+        "pagetables 2097152\n"
+        "sock 4096\n"
+        "shmem 8388608\n"
+        "file_mapped 1\n");
+
+static const QByteArray CgroupEventsSample(
+        "low 0\n"
+        "high 12\n"
+        "max 3\n"
+        "oom 1\n"
+        "oom_kill 1\n"
+        "oom_group_kill 0\n");
+
+static const QByteArray MmStatSample("  4096000  1024000  1228800        0  1228800     1234       10        0        0\n");
+
+// 截断在第一次出现 marker 之后
+static QByteArray truncatedAfter(const QByteArray &data, const char *marker)
+{
+    const int index = data.indexOf(marker);
+    return index < 0 ? data : data.left(index + int(qstrlen(marker)));
+}
+
+TEST(ut_MemInfoSampler, parse)
+{
+    struct Case {
+        const char *name;
+        QByteArray data;
+        bool valid;
+        qulonglong memTotal;
+        qulonglong memAvailable;
+        qulonglong active;
+        qulonglong swapFree;
+    };
+    // 解析失败或字段截断时保留原有的值
+    const qulonglong Previous = 1;
+    const QVector<Case> cases {
+        {"full", MemInfoSample, true, 16303332, 9273500, 5881432, 2040316},
+        {"truncated in number", truncatedAfter(MemInfoSample, "MemAvailable:    9273"), true, 16303332, Previous, Previous, Previous},
+        {"truncated before value", truncatedAfter(MemInfoSample, "Active:"), true, 16303332, 9273500, Previous, Previous},
+        {"missing total", QByteArray(MemInfoSample).replace("MemTotal:", "MemTotaX:"), false, Previous, 9273500, 5881432, 2040316},
+        {"empty", QByteArray(), false, Previous, Previous, Previous, Previous},
+    };
+
+    for (const auto &item : cases) {
+        SCOPED_TRACE(item.name);
+        MemInfo info;
+        info.memTotal = info.memAvailable = info.active = info.swapFree = Previous;
+        ASSERT_EQ(MemInfoSampler::parse(item.data.constData(), item.data.size(), info), item.valid);
+        ASSERT_EQ(info.memTotal, item.memTotal);
+        ASSERT_EQ(info.memAvailable, item.memAvailable);
+        ASSERT_EQ(info.active, item.active);
+        ASSERT_EQ(info.swapFree, item.swapFree);
+    }
+}
+
+TEST(ut_MemInfoSampler, fields)
+{
+    MemInfo info;
+    ASSERT_TRUE(MemInfoSampler::parse(MemInfoSample.constData(), MemInfoSample.size(), info));
+    ASSERT_EQ(info.memFree, 1853084u);
+    ASSERT_EQ(info.buffers, 582924u);
+    ASSERT_EQ(info.cached, 7145236u);
+    ASSERT_EQ(info.swapCached, 12288u);
+    // Active(anon) 与 MemAvailable 等长，不能被误匹配
+    ASSERT_EQ(info.memAvailable, 9273500u);
+    ASSERT_EQ(info.inactive, 6891164u);
+    ASSERT_EQ(info.swapTotal, 2097148u);
+    ASSERT_EQ(info.zswap, 10240u);
+    ASSERT_EQ(info.zswapped, 40960u);
+    ASSERT_EQ(info.dirty, 620u);
+    ASSERT_EQ(info.mapped, 973328u);
+    ASSERT_EQ(info.shmem, 812340u);
+    ASSERT_EQ(info.slab, 702744u);
+}
+
+TEST(ut_PressureSampler, parse)
+{
+    struct Case {
+        const char *name;
+        QByteArray data;
+        bool valid;
+        qreal someAvg10;
+        qreal someAvg60;
+        qulonglong someTotal;
+        qulonglong fullTotal;
+    };
+    const qreal Previous = 99;
+    const QVector<Case> cases {
+        {"full", PressureSample, true, 1.53, 0.87, 1234567, 456789},
+        {"some only", PressureSample.left(PressureSample.indexOf("full")), true, 1.53, 0.87, 1234567, 99},
+        {"truncated in number", truncatedAfter(PressureSample, "avg60=0.8"), true, 1.53, Previous, 99, 99},
+        {"truncated in total", truncatedAfter(PressureSample, "total=1234"), true, 1.53, 0.87, 99, 99},
+        {"missing some", PressureSample.mid(PressureSample.indexOf("full")), false, Previous, Previous, 99, 456789},
+        {"empty", QByteArray(), false, Previous, Previous, 99, 99},
+    };
+
+    for (const auto &item : cases) {
+        SCOPED_TRACE(item.name);
+        PressureInfo info;
+        info.some.avg10 = info.some.avg60 = Previous;
+        info.some.total = info.full.total = 99;
+        ASSERT_EQ(PressureSampler::parse(item.data.constData(), item.data.size(), info), item.valid);
+        ASSERT_NEAR(info.some.avg10, item.someAvg10, 0.001);
+        ASSERT_NEAR(info.some.avg60, item.someAvg60, 0.001);
+        ASSERT_EQ(info.some.total, item.someTotal);
+        ASSERT_EQ(info.full.total, item.fullTotal);
+    }
+}
+
+TEST(ut_CgroupSampler, parseLimit)
+{
+    struct Case {
+        const char *name;
+        QByteArray data;
+        bool valid;
+        qulonglong value;
+    };
+    const qulonglong Previous = 7;
+    const QVector<Case> cases {
+        {"max", "max\n", true, 0},
+        {"max without newline", "max", true, 0},
+        {"bytes", "1073741824\n", true, 1048576},
+        {"empty", "", false, Previous},
+        {"invalid", "abc\n", false, Previous},
+    };
+
+    for (const auto &item : cases) {
+        SCOPED_TRACE(item.name);
+        qulonglong value = Previous;
+        ASSERT_EQ(CgroupSampler::parseLimit(item.data.constData(), item.data.size(), value), item.valid);
+        ASSERT_EQ(value, item.value);
+    }
+}
+
+TEST(ut_CgroupSampler, parseStat)
+{
+    CgroupMemInfo info;
+    ASSERT_TRUE(CgroupSampler::parseStat(CgroupStatSample.constData(), CgroupStatSample.size(), info));
+    ASSERT_EQ(info.anon, 524288u);
+    ASSERT_EQ(info.file, 1048576u);
+    // kernel_stack 不能被当作 kernel
+    ASSERT_EQ(info.kernel, 65536u);
+    ASSERT_EQ(info.shmem, 8192u);
+    ASSERT_EQ(info.sock, 4u);
+
+    // 没有需要的字段，或唯一的字段被截断时不更新
+    CgroupMemInfo unchanged;
+    unchanged.anon = 1;
+    const QByteArray missing("pgfault 10\npgmajfault 2\n");
+    ASSERT_FALSE(CgroupSampler::parseStat(missing.constData(), missing.size(), unchanged));
+    const QByteArray truncated("anon 5368");
+    ASSERT_FALSE(CgroupSampler::parseStat(truncated.constData(), truncated.size(), unchanged));
+    ASSERT_EQ(unchanged.anon, 1u);
+}
+
+TEST(ut_CgroupSampler, parseEvents)
+{
+    CgroupMemInfo info;
+    ASSERT_TRUE(CgroupSampler::parseEvents(CgroupEventsSample.constData(), CgroupEventsSample.size(), info));
+    ASSERT_EQ(info.highEvents, 12u);
+    ASSERT_EQ(info.maxEvents, 3u);
+    ASSERT_EQ(info.oomEvents, 1u);
+    // oom_group_kill 不能被当作 oom_kill
+    ASSERT_EQ(info.oomKillEvents, 1u);
+
+    const QByteArray truncated = truncatedAfter(CgroupEventsSample, "high 1");
+    CgroupMemInfo partial;
+    ASSERT_FALSE(CgroupSampler::parseEvents(truncated.constData(), truncated.size(), partial));
+    ASSERT_EQ(partial.highEvents, 0u);
+}
+
+TEST(ut_ZramSampler, parseMmStat)
+{
+    struct Case {
+        const char *name;
+        QByteArray data;
+        bool valid;
+    };
+    const QVector<Case> cases {
+        {"full", MmStatSample, true},
+        {"truncated in number", truncatedAfter(MmStatSample, "  12"), false},
+        {"missing field", "  4096000  1024000\n", false},
+        {"empty", "", false},
+    };
+
+    for (const auto &item : cases) {
+        SCOPED_TRACE(item.name);
+        ZramInfo info;
+        ASSERT_EQ(ZramSampler::parseMmStat(item.data.constData(), item.data.size(), info), item.valid);
+        ASSERT_EQ(info.origData, item.valid ? 4000u : 0u);
+        ASSERT_EQ(info.comprData, item.valid ? 1000u : 0u);
+        ASSERT_EQ(info.memUsed, item.valid ? 1200u : 0u);
+    }
+
+    // 多个设备的数据累加
+    ZramInfo total;
+    ASSERT_TRUE(ZramSampler::parseMmStat(MmStatSample.constData(), MmStatSample.size(), total));
+    ASSERT_TRUE(ZramSampler::parseMmStat(MmStatSample.constData(), MmStatSample.size(), total));
+    ASSERT_EQ(total.origData, 8000u);
+    ASSERT_EQ(total.memUsed, 2400u);
+    ASSERT_NEAR(total.ratio(), 8000.0 / 2400, 0.001);
+    ASSERT_EQ(ZramInfo().ratio(), 0);
+}
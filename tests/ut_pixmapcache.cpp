@@ -0,0 +1,88 @@
+/*
+ * Copyright (C) 2022 UnionTech Technology Co., Ltd.
+ *
+ * Author:     yeshanshan <yeshanshan@uniontech.com>
+ *
+ * Maintainer: yeshanshan <yeshanshan@uniontech.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include <widgetspixmapcache.h>
+WIDGETS_USE_NAMESPACE
+
+static QPixmap filledPixmap(const QSize &size)
+{
+    QPixmap pixmap(size);
+    pixmap.fill(Qt::red);
+    return pixmap;
+}
+
+TEST(ut_PixmapCache, key)
+{
+    const auto &key = PixmapCache::key("clock", QSize(16, 16), 1, "dark");
+    ASSERT_NE(key, PixmapCache::key("clock", QSize(16, 16), 2, "dark"));
+    ASSERT_NE(key, PixmapCache::key("clock", QSize(16, 16), 1, "light"));
+    ASSERT_NE(key, PixmapCache::key("clock", QSize(32, 16), 1, "dark"));
+    ASSERT_EQ(key, PixmapCache::key("clock", QSize(16, 16), 1, "dark"));
+}
+
+TEST(ut_PixmapCache, loadOnce)
+{
+    auto cache = PixmapCache::instance();
+    cache->clear();
+
+    int loaded = 0;
+    auto loader = [&loaded]() {
+        ++loaded;
+        return filledPixmap(QSize(16, 16));
+    };
+    const auto &key = PixmapCache::key("loadOnce", QSize(16, 16), 1);
+    ASSERT_EQ(cache->pixmap(key, loader).size(), QSize(16, 16));
+    ASSERT_EQ(cache->pixmap(key, loader).size(), QSize(16, 16));
+    ASSERT_EQ(loaded, 1);
+    ASSERT_TRUE(cache->contains(key));
+
+    cache->clear();
+    ASSERT_FALSE(cache->contains(key));
+    ASSERT_EQ(cache->memoryUsage(), 0);
+}
+
+TEST(ut_PixmapCache, budget)
+{
+    auto cache = PixmapCache::instance();
+    cache->clear();
+    const auto budget = cache->memoryBudget();
+
+    // 64x64x32位为16KB，预算只能容纳两张
+    cache->setMemoryBudget(32 * 1024);
+    const auto &first = PixmapCache::key("budget", QSize(64, 64), 1, "first");
+    const auto &second = PixmapCache::key("budget", QSize(64, 64), 1, "second");
+    const auto &third = PixmapCache::key("budget", QSize(64, 64), 1, "third");
+    cache->insert(first, filledPixmap(QSize(64, 64)));
+    cache->insert(second, filledPixmap(QSize(64, 64)));
+    // 访问后first成为最近使用的
+    cache->pixmap(first, nullptr);
+    cache->insert(third, filledPixmap(QSize(64, 64)));
+
+    ASSERT_LE(cache->memoryUsage(), cache->memoryBudget());
+    ASSERT_TRUE(cache->contains(first));
+    ASSERT_FALSE(cache->contains(second));
+    ASSERT_TRUE(cache->contains(third));
+
+    cache->setMemoryBudget(budget);
+    cache->clear();
+}
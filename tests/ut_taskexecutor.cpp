@@ -0,0 +1,99 @@
+/*
+ * Copyright (C) 2022 UnionTech Technology Co., Ltd.
+ *
+ * Author:     yeshanshan <yeshanshan@uniontech.com>
+ *
+ * Maintainer: yeshanshan <yeshanshan@uniontech.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include "taskexecutor.h"
+#include <QCoreApplication>
+#include <QScopedPointer>
+#include <QThread>
+WIDGETS_FRAME_USE_NAMESPACE
+
+static void waitForTasks(TaskExecutor &executor, const PluginId &pluginId)
+{
+    while (executor.pendingCount(pluginId) > 0) {
+        executor.waitForDone();
+        QCoreApplication::processEvents();
+    }
+}
+
+TEST(ut_TaskExecutor, submit)
+{
+    TaskExecutor executor;
+    QObject context;
+    ASSERT_EQ(executor.submit("plugin", "instance", nullptr, []() { return QVariant(); }, nullptr), -1);
+
+    Qt::HANDLE resultThread = nullptr;
+    QVariant result;
+    const int taskId = executor.submit("plugin", "instance", &context, []() {
+        return QVariant(42);
+    }, [&result, &resultThread](const QVariant &value) {
+        result = value;
+        resultThread = QThread::currentThreadId();
+    });
+    ASSERT_GT(taskId, 0);
+
+    waitForTasks(executor, "plugin");
+    ASSERT_EQ(result.toInt(), 42);
+    ASSERT_EQ(resultThread, QThread::currentThreadId());
+}
+
+TEST(ut_TaskExecutor, cancel)
+{
+    TaskExecutor executor;
+    executor.setPluginConcurrency(1);
+    QObject context;
+
+    int count = 0;
+    auto finished = [&count](const QVariant &) { count++; };
+    auto slowTask = []() { QThread::msleep(20); return QVariant(); };
+    const int running = executor.submit("plugin", "instance", &context, slowTask, finished);
+    const int queued = executor.submit("plugin", "instance", &context, slowTask, finished);
+    ASSERT_EQ(executor.pendingCount("plugin"), 2);
+
+    ASSERT_TRUE(executor.cancel(queued));
+    ASSERT_FALSE(executor.cancel(queued));
+    ASSERT_TRUE(executor.cancel(running));
+
+    waitForTasks(executor, "plugin");
+    ASSERT_EQ(count, 0);
+}
+
+TEST(ut_TaskExecutor, cancelAll)
+{
+    TaskExecutor executor;
+    QObject context;
+    QScopedPointer<QObject> released(new QObject());
+
+    int count = 0;
+    auto finished = [&count](const QVariant &) { count++; };
+    auto task = []() { return QVariant(); };
+    executor.submit("plugin", "removed", &context, task, finished);
+    executor.submit("plugin", "removed", &context, task, finished);
+    executor.submit("plugin", "released", released.data(), task, finished);
+    executor.submit("plugin", "instance", &context, task, finished);
+
+    executor.cancelAll("removed");
+    released.reset();
+
+    waitForTasks(executor, "plugin");
+    ASSERT_EQ(count, 1);
+}
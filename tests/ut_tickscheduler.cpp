@@ -0,0 +1,100 @@
+/*
+ * Copyright (C) 2022 UnionTech Technology Co., Ltd.
+ *
+ * Author:     yeshanshan <yeshanshan@uniontech.com>
+ *
+ * Maintainer: yeshanshan <yeshanshan@uniontech.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include "tickscheduler.h"
+#include <QObject>
+#include <QScopedPointer>
+WIDGETS_FRAME_USE_NAMESPACE
+
+TEST(ut_TickScheduler, nextAlignedTime)
+{
+    ASSERT_EQ(TickScheduler::nextAlignedTime(0, 1000), 1000);
+    ASSERT_EQ(TickScheduler::nextAlignedTime(999, 1000), 1000);
+    ASSERT_EQ(TickScheduler::nextAlignedTime(1000, 1000), 2000);
+    ASSERT_EQ(TickScheduler::nextAlignedTime(61500, 60000), 120000);
+    ASSERT_EQ(TickScheduler::nextAlignedTime(1234, 0), 1234);
+}
+
+TEST(ut_TickScheduler, subscribe)
+{
+    TickScheduler scheduler;
+    QObject context;
+    ASSERT_EQ(scheduler.subscribe("instance", 1000, nullptr, []() {}), -1);
+
+    const int first = scheduler.subscribe("instance", 1000, &context, []() {});
+    const int second = scheduler.subscribe("instance", 60000, &context, []() {});
+    scheduler.subscribe("other", 1000, &context, []() {});
+    ASSERT_NE(first, second);
+    ASSERT_EQ(scheduler.count(), 3);
+
+    scheduler.unsubscribe(first);
+    ASSERT_EQ(scheduler.count(), 2);
+
+    scheduler.unsubscribeAll("instance");
+    ASSERT_EQ(scheduler.count(), 1);
+}
+
+TEST(ut_TickScheduler, resume)
+{
+    TickScheduler scheduler;
+    ASSERT_TRUE(scheduler.isPaused());
+
+    int count = 0;
+    QObject context;
+    QScopedPointer<QObject> released(new QObject());
+    scheduler.subscribe("instance", 1000, &context, [&count]() { count++; });
+    scheduler.subscribe("released", 1000, released.data(), [&count]() { count++; });
+    released.reset();
+
+    // 恢复时立即回调，已销毁的context被移除
+    scheduler.setPaused(false);
+    ASSERT_EQ(count, 1);
+    ASSERT_EQ(scheduler.count(), 1);
+
+    scheduler.setPaused(true);
+    scheduler.setPaused(true);
+    ASSERT_EQ(count, 1);
+}
+
+TEST(ut_TickScheduler, instancePaused)
+{
+    TickScheduler scheduler;
+    scheduler.setPaused(false);
+
+    int count = 0;
+    QObject context;
+    scheduler.subscribe("instance", 1000, &context, [&count]() { count++; });
+
+    scheduler.setInstancePaused("instance", true);
+    ASSERT_TRUE(scheduler.isInstancePaused("instance"));
+    ASSERT_EQ(count, 0);
+
+    // 组件重新可见时立即回调
+    scheduler.setInstancePaused("instance", false);
+    ASSERT_FALSE(scheduler.isInstancePaused("instance"));
+    ASSERT_EQ(count, 1);
+
+    scheduler.setInstancePaused("instance", true);
+    scheduler.unsubscribeAll("instance");
+    ASSERT_FALSE(scheduler.isInstancePaused("instance"));
+}
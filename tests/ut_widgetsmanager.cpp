@@ -24,8 +24,18 @@
 #include "widgetmanager.h"
 #include "instanceproxy.h"
 #include "pluginspec.h"
+#include "pluginlibrary.h"
+#include "taskexecutor.h"
+#include "memoryaccountant.h"
+#include "allocationcounter.h"
+#include "instancemodel.h"
+#include "displaymodepanel.h"
+#include "widgetstore.h"
 #include "helper.hpp"
 
+#include <QCoreApplication>
+#include <QThread>
+
 WIDGETS_FRAME_USE_NAMESPACE
 static PluginGuard pluginGuard;
 class ut_WidgetManager : public ::testing::Test
@@ -78,6 +88,157 @@ TEST_F(ut_WidgetManager, removeWidget)
     ASSERT_FALSE(manager.getInstance(instanceId));
 }
 
+TEST_F(ut_WidgetManager, unloadWhenIdle)
+{
+    WidgetManager manager;
+    manager.loadPlugins();
+    auto plugin = manager.getPlugin(ExamplePluginId);
+    ASSERT_TRUE(plugin);
+    const auto title = plugin->title();
+    auto library = plugin->library();
+    library->setUnloadable(true);
+
+    auto instance = plugin->createWidget(IWidget::Middle);
+    ASSERT_TRUE(instance);
+    ASSERT_EQ(library->refCount(), 1);
+    ASSERT_FALSE(library->unload());
+    ASSERT_TRUE(library->isLoaded());
+
+    delete instance;
+    ASSERT_EQ(library->refCount(), 0);
+    ASSERT_TRUE(library->unload());
+    ASSERT_FALSE(library->isLoaded());
+    ASSERT_EQ(plugin->title(), title);
+
+    // 再次使用时重新加载
+    instance = plugin->createWidget(IWidget::Middle);
+    ASSERT_TRUE(instance);
+    ASSERT_TRUE(library->isLoaded());
+    delete instance;
+}
+
+TEST_F(ut_WidgetManager, unloadWithRunningTask)
+{
+    WidgetManager manager;
+    manager.loadPlugins();
+    auto plugin = manager.getPlugin(ExamplePluginId);
+    ASSERT_TRUE(plugin);
+    auto library = plugin->library();
+    library->setUnloadable(true);
+    ASSERT_TRUE(library->isLoaded());
+
+    auto executor = TaskExecutor::instance();
+    QObject context;
+    executor->submit(ExamplePluginId, "instance", &context, []() {
+        QThread::msleep(20);
+        return QVariant();
+    }, nullptr);
+    ASSERT_FALSE(library->unload());
+    ASSERT_TRUE(library->isLoaded());
+
+    while (executor->pendingCount(ExamplePluginId) > 0) {
+        executor->waitForDone();
+        QCoreApplication::processEvents();
+    }
+    ASSERT_TRUE(library->unload());
+    ASSERT_FALSE(library->isLoaded());
+}
+
+TEST_F(ut_WidgetManager, memoryAccounting)
+{
+    if (!AllocationCounter::isSupported())
+        return;
+
+    WidgetManager manager;
+    manager.loadPlugins();
+    auto plugin = manager.getPlugin(ExamplePluginId);
+    ASSERT_TRUE(plugin);
+
+    auto accountant = MemoryAccountant::instance();
+    accountant->setEnabled(true);
+    // 首次创建会初始化Qt内部的缓存，不计入本次检查
+    auto instance = plugin->createWidget(IWidget::Middle);
+    ASSERT_TRUE(instance);
+    instance->view();
+    delete instance;
+    accountant->clear();
+
+    instance = plugin->createWidget(IWidget::Middle);
+    ASSERT_TRUE(instance);
+    instance->view();
+    const qint64 created = accountant->liveBytes(ExamplePluginId);
+    ASSERT_GT(created, 0);
+
+    delete instance;
+    ASSERT_LT(accountant->liveBytes(ExamplePluginId), created / 2);
+
+    accountant->setEnabled(false);
+    accountant->clear();
+}
+
+TEST_F(ut_WidgetManager, memoryAccountingPanelRemoval)
+{
+    if (!AllocationCounter::isSupported())
+        return;
+
+    WidgetManager manager;
+    manager.loadPlugins();
+    InstanceModel model(&manager);
+    DisplayModePanel panel(&manager);
+    panel.setModel(&model);
+    panel.setEnabledMode(true);
+
+    auto accountant = MemoryAccountant::instance();
+    accountant->setEnabled(true);
+    // 单元格和实例都是延迟释放，按界面上的删除顺序处理
+    auto instance = model.addInstance(ExamplePluginId, IWidget::Middle);
+    ASSERT_TRUE(instance);
+    model.removeInstance(instance->handler()->id());
+    QCoreApplication::sendPostedEvents(nullptr, QEvent::DeferredDelete);
+    accountant->clear();
+
+    instance = model.addInstance(ExamplePluginId, IWidget::Middle);
+    ASSERT_TRUE(instance);
+    const qint64 created = accountant->liveBytes(ExamplePluginId);
+    ASSERT_GT(created, 0);
+
+    model.removeInstance(instance->handler()->id());
+    QCoreApplication::sendPostedEvents(nullptr, QEvent::DeferredDelete);
+    ASSERT_LT(accountant->liveBytes(ExamplePluginId), created / 2);
+
+    accountant->setEnabled(false);
+    accountant->clear();
+}
+
+TEST_F(ut_WidgetManager, memoryAccountingReleasePreviews)
+{
+    if (!AllocationCounter::isSupported())
+        return;
+
+    WidgetManager manager;
+    manager.loadPlugins();
+    WidgetStore store(&manager);
+
+    auto accountant = MemoryAccountant::instance();
+    accountant->setEnabled(true);
+    store.loadPreviews();
+    store.releasePreviews();
+    QCoreApplication::sendPostedEvents(nullptr, QEvent::DeferredDelete);
+    accountant->clear();
+
+    store.loadPreviews();
+    ASSERT_TRUE(store.isPreviewsLoaded());
+    const qint64 created = accountant->liveBytes(ExamplePluginId);
+    ASSERT_GT(created, 0);
+
+    store.releasePreviews();
+    QCoreApplication::sendPostedEvents(nullptr, QEvent::DeferredDelete);
+    ASSERT_LT(accountant->liveBytes(ExamplePluginId), created / 2);
+
+    accountant->setEnabled(false);
+    accountant->clear();
+}
+
 static WidgetManager gManager;
 class ut_WidgetPluginSpec : public ::testing::Test
 {
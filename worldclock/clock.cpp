@@ -30,9 +30,11 @@
 #include <DFontSizeManager>
 #include <DFontManager>
 #include <QApplication>
+#include <widgetspixmapcache.h>
 
 DGUI_USE_NAMESPACE
 DWIDGET_USE_NAMESPACE
+WIDGETS_USE_NAMESPACE
 namespace dwclock {
 static const QSize baseClockSize = QSize(224, 224);
 static const QSize basePointSize = QSize(224, 224);
@@ -49,20 +51,16 @@ Clock::~Clock()
 
 QPixmap Clock::getPixmap(const QString &name, const QSize &size)
 {
-    const QIcon &icon = QIcon::fromTheme(name);
-    const auto ratio = qApp->devicePixelRatio();
-    QPixmap pixmap = icon.pixmap(size * ratio).scaled(size * ratio, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
-    QPainter p(&pixmap);
-    p.setRenderHints(QPainter::Antialiasing);
-    p.drawPixmap(0, 0, pixmap);
-    pixmap.setDevicePixelRatio(ratio);
-    return pixmap;
+    return PixmapCache::instance()->themeIcon(name, size, qApp->devicePixelRatio());
 }
 
 QPixmap Clock::getPixmap(const QString &name, const int size, const bool isDark)
 {
-    const auto &icon = DDciIcon::fromTheme(name);
-    return icon.pixmap(1, size, isDark ? DDciIcon::Dark : DDciIcon::Light);
+    const auto &key = PixmapCache::key(name, QSize(size, size), 1, isDark ? "dci-dark" : "dci-light");
+    return PixmapCache::instance()->pixmap(key, [name, size, isDark]() {
+        const auto &icon = DDciIcon::fromTheme(name);
+        return icon.pixmap(1, size, isDark ? DDciIcon::Dark : DDciIcon::Light);
+    });
 }
 
 void Clock::paint(QPainter *painter, const QRect &rect)
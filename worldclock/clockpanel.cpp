@@ -28,7 +28,6 @@
 #include <QLabel>
 #include <QVBoxLayout>
 #include <DFontSizeManager>
-#include <QTimer>
 #include <QPainter>
 #include <QDateTime>
 #include <QtMath>
@@ -189,11 +188,6 @@ ClockView::ClockView(QWidget *parent)
     setSelectionMode(QAbstractItemView::NoSelection);
     setHorizontalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
     setVerticalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
-
-    // Update per second.
-    QTimer *timer = new QTimer(this);
-    connect(timer, &QTimer::timeout, this, [this](){ update(); });
-    timer->start(1000);
 }
 
 ClockView::~ClockView()
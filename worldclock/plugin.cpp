@@ -65,6 +65,12 @@ bool WorldClockWidget::initialize(const QStringList &arguments) {
         handler()->setValue("locations", timezones);
     });
 
+    // Update per second, ticks are aligned and paused by the host.
+    auto clockPanel = m_viewManager->clockPanel();
+    handler()->subscribeTick(WidgetHandler::PerSecond, clockPanel, [clockPanel]() {
+        clockPanel->view()->update();
+    });
+
     return true;
 }
 
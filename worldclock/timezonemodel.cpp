@@ -22,9 +22,9 @@
 #include "timezonemodel.h"
 #include "utils/zoneinfo.h"
 #include "utils/timezone.h"
+#include "common/dbushelper.hpp"
 
 #include <QDebug>
-#include <QDBusInterface>
 #include <QDBusPendingReply>
 #include <QEvent>
 #include <DStyledItemDelegate>
@@ -129,26 +129,22 @@ QStringList TimezoneModel::defaultLocations()
 
 void TimezoneModel::updateTimezoneOffset(QStandardItem *item, const QString &timezone)
 {
-    QDBusInterface interface ("org.deepin.dde.Timedate1", "/org/deepin/dde/Timedate1", "org.deepin.dde.Timedate1", QDBusConnection::sessionBus());
-    auto reply = interface.asyncCall("GetZoneInfo", timezone);
-    QDBusPendingCallWatcher *watcher = new QDBusPendingCallWatcher(reply, this);
-
-    QObject::connect(watcher, &QDBusPendingCallWatcher::finished, this,
-                     [this, timezone, item](QDBusPendingCallWatcher* call) {
-        static bool Registered = false;
-        if (!Registered) {
-            registerZoneInfoMetaType();
-            Registered = true;
-        }
+    // reply is demarshalled before the callback, so register the type ahead of the call.
+    static bool Registered = false;
+    if (!Registered) {
+        registerZoneInfoMetaType();
+        Registered = true;
+    }
 
-        QDBusPendingReply<ZoneInfo> reply = *call;
+    static const DBusHelper timedate("org.deepin.dde.Timedate1", "/org/deepin/dde/Timedate1", "org.deepin.dde.Timedate1");
+    timedate.asyncCall<ZoneInfo>("GetZoneInfo", {timezone}, this,
+                                 [timezone, item](const QDBusPendingReply<ZoneInfo> &reply) {
         if (reply.isError()) {
             qWarning() << "It's error for GetZoneInfo [" << timezone << "] :" << reply.error().message();
         } else {
             const auto info = reply.value();
             item->setData(info.getUTCOffset(), ZoneOffset);
         }
-        call->deleteLater();
     });
 }
 